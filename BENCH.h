@@ -0,0 +1,58 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//BENCHMARK
+//8080 test program, loaded to TPA
+const static uint8_t PROGMEM bench_code[] = {
+  0x16, 0x04,             //0100 MVI D,4
+  0x01, 0x00, 0x20,       //0102 LXI B,2000H
+  0x0B,                   //0105 DCX B
+  0x78,                   //0106 MOV A,B
+  0xB1,                   //0107 ORA C
+  0xC2, 0x05, 0x01,       //0108 JNZ 0105H
+  0x15,                   //010B DCR D
+  0xC2, 0x02, 0x01,       //010C JNZ 0102H
+  0x76,                   //010F HLT
+};
+const uint16_t BENCH_LEN = 16;//program length
+const uint16_t BENCH_START = TBASE;//program start
+const uint32_t BENCH_INSTR = 1UL + 4UL * (1UL + 0x2000UL * 4UL + 2UL) + 1UL;//instructions executed
+
+//emulated instructions rate
+void bench() {
+  uint16_t i;
+  uint32_t start_time;
+  uint32_t elapsed;
+  uint32_t cycles;
+  boolean debug_tmp;
+  for (i = 0; i < BENCH_LEN; i++) {
+    _setMEM(BENCH_START + i, pgm_read_byte_near(bench_code + i));
+  }
+  debug_tmp = DEBUG;
+  DEBUG = false;
+  cycles = CYCLES;
+  start_time = millis();
+  call(BENCH_START);
+  elapsed = millis() - start_time;
+  cycles = CYCLES - cycles;
+  DEBUG = debug_tmp;
+  Serial.print(BENCH_INSTR, DEC);
+  Serial.print(F(" INSTR, "));
+  Serial.print(elapsed, DEC);
+  Serial.println(F(" MS"));
+  if (elapsed != 0) {
+    Serial.print(BENCH_INSTR * 1000UL / elapsed, DEC);
+    Serial.println(F(" INSTR/S"));
+  }
+  #if CYCLE_COUNT
+  Serial.print(cycles, DEC);
+  Serial.println(F(" T-STATES"));
+  if (elapsed != 0) {
+    Serial.print(cycles / elapsed, DEC);
+    Serial.println(F(" KHZ"));
+  }
+  #endif
+}
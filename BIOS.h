@@ -20,23 +20,73 @@ void _BIOS_RET() {
     uint16_t a16;
     //RET
     _AB = _SP;
-    _RDMEM();
-    a16 = _DB;
-    _SP++;
-    _AB = _SP;
-    _RDMEM();
-    a16 = a16 + 256 * _DB;
-    _SP++;
+    a16 = _RDMEM16();
+    _SP = _SP + 2;
     _PC = a16;
     _AB = _PC;
 }
 
+//BIOS trap
+//BIOS vector entry: JMP to its trap - TRAP, function index (_TRAPS, CPM_def.h)
+//BDOS entry (FBASE): JMP retargeted to the last trap - TRAP, BDOS_TRAP_FN, JMP target is saved
+//vector & BDOS entry keep real JMPs, so programs may read the targets,
+//patch an entry and chain to the old target (trap)
+const uint8_t BIOS_TRAP_OP = 0x08;//*NOP slot
+const uint8_t BIOS_FN_NUM = (_BIOS_HI - _BIOS_LO + 1) / 3;//BIOS functions number
+const uint8_t BDOS_TRAP_FN = 0xFF;//BDOS entry trap
+const uint16_t BDOS_TRAP = _TRAPS + 2 * BIOS_FN_NUM;//BDOS entry trap address
+uint16_t BDOS_ENTRY = 0;//BDOS entry JMP target
+
+//BDOS move (C bytes from DE to HL) - trap, native move by memory DMA controller
+//move: INR C / move0: DCR C / RZ / LDAX D / MOV M,A / INX D / INX H / JMP move0
+//Digital Research CP/M 2.2 BDOS: 6 bytes serial number, entry JMP (FBASE), ..., move at +0x34F;
+//other BDOS builds - code check fails, no trap
+const uint16_t BDOS_BASE = FBASE - 6;//BDOS start (0xE400 - 64K)
+const uint16_t BDOS_MOVE_OFS = 0x34FU;//move subroutine offset in CP/M 2.2 BDOS
+const uint16_t BDOS_MOVE = BDOS_BASE + BDOS_MOVE_OFS;//BDOS move subroutine
+const uint8_t BDOS_MOVE_CODE[] = { 0x0C, 0x0D, 0xC8, 0x1A, 0x77, 0x13, 0x23, 0xC3 };
+boolean BDOS_MOVE_TRAP = false;//move subroutine patched
+
+//BIOS vector & BDOS entry traps
+//cold - BIOS vector set (warm boot keeps entries patched by programs)
+void _BIOS_VECTOR(boolean cold) {
+  uint8_t fn;
+  for (fn = 0; fn < BIOS_FN_NUM; fn++) {
+    if (cold) {
+      _setMEM(_BIOS + fn * 3U, 0xC3);//JMP
+      _setMEM(_BIOS + fn * 3U + 1, lowByte(_TRAPS + fn * 2U));
+      _setMEM(_BIOS + fn * 3U + 2, highByte(_TRAPS + fn * 2U));
+    }
+    _setMEM(_TRAPS + fn * 2U, BIOS_TRAP_OP);
+    _setMEM(_TRAPS + fn * 2U + 1, fn);
+  }
+  //BDOS entry - JMP
+  if ((_getMEM(FBASE) == 0xC3) && (word(_getMEM(FBASE + 2), _getMEM(FBASE + 1)) != BDOS_TRAP)) {
+    BDOS_ENTRY = word(_getMEM(FBASE + 2), _getMEM(FBASE + 1));
+    _setMEM(FBASE + 1, lowByte(BDOS_TRAP));
+    _setMEM(FBASE + 2, highByte(BDOS_TRAP));
+  }
+  _setMEM(BDOS_TRAP, BIOS_TRAP_OP);
+  _setMEM(BDOS_TRAP + 1, BDOS_TRAP_FN);
+  //BDOS move - trap (only if code is as expected)
+  BDOS_MOVE_TRAP = (_getMEM(BDOS_MOVE + sizeof(BDOS_MOVE_CODE)) == lowByte(BDOS_MOVE + 1)) && (_getMEM(BDOS_MOVE + sizeof(BDOS_MOVE_CODE) + 1) == highByte(BDOS_MOVE + 1));
+  for (fn = 0; fn < sizeof(BDOS_MOVE_CODE); fn++) {
+    if (_getMEM(BDOS_MOVE + fn) != BDOS_MOVE_CODE[fn]) {
+      BDOS_MOVE_TRAP = false;
+    }
+  }
+  if (BDOS_MOVE_TRAP) {
+    _setMEM(BDOS_MOVE, BIOS_TRAP_OP);
+  }
+}
+
 #define CPMSYS_COUNT 11
 #define CPMSYS_LEN 5632
 #define CPMSYS_START 0x100
 #define CPMSYS_CS 0x1A
 
-boolean _IPL() {
+//cold - cold start (BIOS vector set)
+boolean _IPL(boolean cold) {
   uint16_t i;
   uint16_t j;
   uint16_t k;
@@ -48,19 +98,19 @@ boolean _IPL() {
   char hex[2];
   if (CPM_logo) {
   Serial.print(RAM_SIZE, DEC);
-  Serial.println("K SYSTEM");
-  Serial.print("CBASE: ");
+  Serial.println(F("K SYSTEM"));
+  Serial.print(F("CBASE: "));
   Serial.write(0x09);
   Serial.println(CBASE, HEX); 
-  Serial.print("FBASE: ");
+  Serial.print(F("FBASE: "));
   Serial.write(0x09);
   Serial.println(FBASE, HEX);
-  Serial.print("BIOS: ");
+  Serial.print(F("BIOS: "));
   Serial.write(0x09);
   Serial.print(_BIOS_LO, HEX);
-  Serial.print(" ... ");
+  Serial.print(F(" ... "));
   Serial.println(_BIOS_HI, HEX);
-  Serial.println("");
+  Serial.println();
   Serial.println(F("IPL"));
   }  
   _SP = SP_INIT;
@@ -94,11 +144,11 @@ boolean _IPL() {
       }
   }
   if (CPM_logo) {
-    Serial.println("");
+    Serial.println();
     Serial.print(F("Checksum: "));
     sprintf(hex, "%02X", checksum);
     Serial.print(hex);
-    Serial.print(" ");
+    Serial.print(F(" "));
   }
   if (checksum != CPMSYS_CS) {
      Serial.println(F("ERR!"));
@@ -107,6 +157,7 @@ boolean _IPL() {
   else {
      Serial.println(F("O.K.!"));
      success = true;
+     _BIOS_VECTOR(cold);
 
      if (CPM_logo) {
      for(j=CPM_LBL_START;j<(CPM_LBL_START+CPM_LBL_LEN);j++) {
@@ -114,7 +165,7 @@ boolean _IPL() {
         _RDMEM();
         Serial.write(_DB);
      }
-     Serial.println("");
+     Serial.println();
      Serial.print(F("Serial: "));
      for(j=CPM_SERIAL_START;j<(CPM_SERIAL_START+CPM_SERIAL_LEN);j++) {
         _AB = CBASE+j;
@@ -122,7 +173,7 @@ boolean _IPL() {
         sprintf(hex, "%02X", _DB);
         Serial.print(hex);
      }
-     Serial.println("");
+     Serial.println();
      }
     i = _DPBASE;
     for (l=0; l<FDD_NUM; l++) {     
@@ -255,6 +306,9 @@ boolean _IPL() {
     _AB = i + 0xF;
     _DB = 0;
     _WRMEM();
+#if RAM_DISK
+    rd_init();//drive M:
+#endif
   /*      
      BLS       BSH     BLM           EXM
    -----      ---     ---     DSM<256   DSM>=256
@@ -306,7 +360,7 @@ void _GOCPM(boolean jmp) {
 void _BOOT() {
     //message BOOT
     if (CPM_logo) {
-      Serial.println("");
+      Serial.println();
       Serial.println(F("BOOT"));
     }
     _AB = IOBYTE;
@@ -323,13 +377,13 @@ void _WBOOT() {
   boolean load;
     //message WBOOT
     if (CPM_logo) {
-      Serial.println("");
+      Serial.println();
       Serial.println(F("WBOOT"));
     }
     //USE SPACE BELOW BUFFER FOR STACK
     _SP = 0x80;
     do {
-      load = _IPL();
+      load = _IPL(false);
     } while (!load);
     //INITIALIZE AND GO TO CP/M
     _GOCPM(true);
@@ -416,6 +470,17 @@ void _BIOS_SELDSK() {
      uint16_t a16;
      uint8_t d8;
      d8 = _rC;
+#if RAM_DISK
+      if (d8 == RD_DRV) {
+        _AB = word(FDD_PORT_DRV, FDD_PORT_DRV);
+        _DB = d8;
+        _OUTPORT();
+        _rH = highByte(_RD_DPH);
+        _rL = lowByte(_RD_DPH);
+        _BIOS_RET();
+        return;
+      }
+#endif
       if (d8>(FDD_NUM-1)) {
         _rH = 0;
         _rL = 0;  
@@ -486,3 +551,111 @@ void _BIOS_SECTRAN() {
     _BIOS_RET();    
 }
 
+//BIOS functions (BIOS vector order)
+const CmdFunction BIOS_fns [] PROGMEM = {
+  _BIOS_BOOT,//0x00
+  _BIOS_WBOOT,//0x03
+  _BIOS_CONST,//0x06
+  _BIOS_CONIN,//0x09
+  _BIOS_CONOUT,//0x0C
+  _BIOS_LIST,//0x0F
+  _BIOS_PUNCH,//0x12
+  _BIOS_READER,//0x15
+  _BIOS_HOME,//0x18
+  _BIOS_SELDSK,//0x1B
+  _BIOS_SETTRK,//0x1E
+  _BIOS_SETSEC,//0x21
+  _BIOS_SETDMA,//0x24
+  _BIOS_READ,//0x27
+  _BIOS_WRITE,//0x2A
+  _BIOS_LISTST,//0x2D
+  _BIOS_SECTRAN,//0x30
+};
+
+//BDOS move
+//C bytes from DE to HL, HL & DE advanced, C = 0, A - last byte
+//flags & T-states - as by the loop: INR C, (DCR C, RZ, LDAX D, MOV M,A, INX D, INX H, JMP) x C, DCR C, RZ
+void _BDOS_MOVE() {
+    uint8_t reg[DMA_REGS_NUM];
+    uint16_t src;
+    uint16_t dst;
+    uint8_t i;
+    src = word(_rD, _rE);
+    dst = word(_rH, _rL);
+#if CYCLE_COUNT
+    //trap opcode already counted in place of INR C
+    CYCLES += clk_op(0x0C) - clk_op(0x08);
+    CYCLES += (uint32_t)_rC * (clk_op(0x0D) + clk_op(0xC8) + clk_op(0x1A) + clk_op(0x77) + clk_op(0x13) + clk_op(0x23) + clk_op(0xC3));
+    CYCLES += clk_op(0x0D) + clk_op(0xC8);
+    _CLK_COND();//RZ taken
+#endif
+    if (_rC) {
+      if ((dst != src) && ((uint16_t)(dst - src) < _rC)) {
+        //upper overlapping area - bytes repeated, as by the loop
+        for (i = 0; i < _rC; i++) {
+          _setMEM(dst + i, _getMEM(src + i));
+        }
+      }
+      else {
+        dma_regs(reg, DMA_CPU, src, DMA_CPU, dst, _rC);
+        dma_run(reg, DMA_MOVE_CMD);
+      }
+      _rA = _getMEM(dst + _rC - 1);
+      src = src + _rC;
+      dst = dst + _rC;
+      _rD = highByte(src);
+      _rE = lowByte(src);
+      _rH = highByte(dst);
+      _rL = lowByte(dst);
+      _rC = 0;
+    }
+    _ALU_FLAGS(LF_DCR, 1, 1, 0);//last DCR C: 1 -> 0
+    _BIOS_RET();
+}
+
+//BIOS trap
+//outside of BIOS traps & BDOS move - NOP
+void _BIOS_TRAP() {
+  uint8_t fn;
+  if (BIOS_INT && BDOS_MOVE_TRAP && (_PC == BDOS_MOVE)) {
+    _BDOS_MOVE();
+  }
+  else if (BIOS_INT && (_PC >= _TRAPS) && (_PC < _ENDTRAP)) {
+    _AB = _PC + 1;
+    _FETCH();
+    fn = _DB;
+    if (fn == BDOS_TRAP_FN) {
+      if (DEBUG) 
+      {
+      color(3);
+      Serial.print(F("BDOS Fn:"));
+      Serial.print(_Regs[_Reg_C], HEX);
+      Serial.print(F(" DE="));
+      Serial.print(_Regs[_Reg_D], HEX);
+      Serial.println(_Regs[_Reg_E], HEX);
+      color(9);
+      }
+      _PC = BDOS_ENTRY;//JMP
+    }
+    else {
+      if (DEBUG) 
+      {
+      color(4);
+      Serial.print(F("BIOS Fn:"));
+      Serial.print(_BIOS + fn * 3U, HEX);
+      Serial.print(F(" C="));
+      Serial.println(_Regs[_Reg_C], HEX);
+      color(9);
+      }
+      if (fn < BIOS_FN_NUM) {
+        ((CmdFunction) pgm_read_word (&BIOS_fns [fn])) ();
+      }
+      else {
+        ATN |= ATN_EXIT;//BIOS error
+      }
+    }
+  }
+  else {
+    _PC++;//*NOP
+  }
+}
@@ -0,0 +1,96 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//i8080 T-states accounting
+//1 - T-states counter, wait states & speed governor
+//0 - off
+#define CYCLE_COUNT 1
+
+//T-states ports
+//0xE8..0xEB - T-states counter (read 0xE8 latches all 4 bytes), write 0xE8 - counter reset
+//0xEC..0xED - governor target, kHz (0 - off)
+//0xEE - memory wait states
+const uint8_t CLK_BASE = 0xE8;//T-states base address
+const uint8_t CLK_PORT_CNT0 = CLK_BASE + 0;//counter byte 0 (LSB)
+const uint8_t CLK_PORT_CNT1 = CLK_BASE + 1;//counter byte 1
+const uint8_t CLK_PORT_CNT2 = CLK_BASE + 2;//counter byte 2
+const uint8_t CLK_PORT_CNT3 = CLK_BASE + 3;//counter byte 3 (MSB)
+const uint8_t CLK_PORT_KHZ_LO = CLK_BASE + 4;//governor target low byte
+const uint8_t CLK_PORT_KHZ_HI = CLK_BASE + 5;//governor target high byte
+const uint8_t CLK_PORT_WAIT = CLK_BASE + 6;//memory wait states
+
+//opcode T-states
+//bits 4..0 - T-states (Cccc, Rccc - condition false)
+//bits 7..5 - memory machine cycles (wait states are added to each one)
+const uint8_t CLK_T = B00011111;
+const uint8_t T_COND = 6;//Cccc, Rccc - condition true, extra T-states
+const uint8_t M_COND = 2;//Cccc, Rccc - condition true, extra memory machine cycles
+const static uint8_t PROGMEM op_cycles[] = {
+  0x24, 0x6A, 0x47, 0x25, 0x25, 0x25, 0x47, 0x24, 0x24, 0x2A, 0x47, 0x25, 0x25, 0x25, 0x47, 0x24,
+  0x24, 0x6A, 0x47, 0x25, 0x25, 0x25, 0x47, 0x24, 0x24, 0x2A, 0x47, 0x25, 0x25, 0x25, 0x47, 0x24,
+  0x24, 0x6A, 0xB0, 0x25, 0x25, 0x25, 0x47, 0x24, 0x24, 0x2A, 0xB0, 0x25, 0x25, 0x25, 0x47, 0x24,
+  0x24, 0x6A, 0x8D, 0x25, 0x6A, 0x6A, 0x6A, 0x24, 0x24, 0x2A, 0x8D, 0x25, 0x25, 0x25, 0x47, 0x24,
+  0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25,
+  0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25,
+  0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25,
+  0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x27, 0x47, 0x25, 0x25, 0x25, 0x25, 0x25, 0x25, 0x47, 0x25,
+  0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24,
+  0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24,
+  0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24,
+  0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x47, 0x24,
+  0x25, 0x6A, 0x6A, 0x6A, 0x6B, 0x6B, 0x47, 0x6B, 0x25, 0x6A, 0x6A, 0x6A, 0x6B, 0xB1, 0x47, 0x6B,
+  0x25, 0x6A, 0x6A, 0x4A, 0x6B, 0x6B, 0x47, 0x6B, 0x25, 0x6A, 0x6A, 0x4A, 0x6B, 0xB1, 0x47, 0x6B,
+  0x25, 0x6A, 0x6A, 0xB2, 0x6B, 0x6B, 0x47, 0x6B, 0x25, 0x25, 0x6A, 0x24, 0x6B, 0xB1, 0x47, 0x6B,
+  0x25, 0x6A, 0x6A, 0x24, 0x6B, 0x6B, 0x47, 0x6B, 0x25, 0x25, 0x6A, 0x24, 0x6B, 0xB1, 0x47, 0x6B,
+};
+
+uint32_t CYCLES = 0;//T-states counter
+uint32_t CYCLES_LATCH;//T-states counter latch (port read)
+uint8_t MEM_WAIT = 0;//memory wait states
+uint16_t CLK_KHZ = 0;//governor target, kHz (0 - off)
+const uint16_t CLK_SLICE = 2048;//governor check period, T-states
+uint32_t CLK_C0;//governor T-states reference
+uint32_t CLK_T0;//governor time reference, us
+
+//governor start
+void clk_start() {
+  CLK_C0 = CYCLES;
+  CLK_T0 = micros();
+}
+
+//governor - wait until emulated time catches up with real time
+void clk_governor() {
+  uint32_t t;
+  t = (CYCLES - CLK_C0) * 1000UL / CLK_KHZ;//emulated time, us
+  if ((micros() - CLK_T0) < t) {
+    while ((micros() - CLK_T0) < t) {};
+    CLK_T0 = CLK_T0 + t;
+  }
+  else {
+    CLK_T0 = micros();//slower than target - no catching up
+  }
+  CLK_C0 = CYCLES;
+}
+
+#if CYCLE_COUNT
+//T-states for opcode, memory wait states included (native code standing in for 8080 code)
+uint8_t clk_op(uint8_t op) {
+  uint8_t c;
+  c = pgm_read_byte(&op_cycles[op]);
+  return (c & CLK_T) + MEM_WAIT * (c >> 5);
+}
+
+//T-states for executed opcode
+#define _CLK_STEP(op) \
+    { uint8_t c = pgm_read_byte(&op_cycles[op]); \
+      CYCLES += (c & CLK_T) + MEM_WAIT * (c >> 5); \
+      if (CLK_KHZ && ((CYCLES - CLK_C0) >= CLK_SLICE)) { clk_governor(); } }
+//Cccc, Rccc - condition true
+#define _CLK_COND() CYCLES += T_COND + MEM_WAIT * M_COND;
+#else
+#define _CLK_STEP(op)
+#define _CLK_COND()
+#endif
@@ -35,6 +35,21 @@ const uint8_t CTRL_O_KEY = 0x0F;
 const uint8_t CTRL_X_KEY = 0x18;
 const uint8_t CTRL_SLASH_KEY = 0x1F;
 
+//console idle (background memory write-back)
+//data port wait loop - every pass, status port - after CON_IDLE_POLLS empty polls in a row
+const uint8_t CON_IDLE_POLLS = 32;
+uint8_t con_idle_cnt = 0;//empty status polls in a row
+
+//console idle status poll
+void con_idle() {
+  if (con_idle_cnt < CON_IDLE_POLLS) {
+    con_idle_cnt++;
+  }
+  else {
+    mem_idle();
+  }
+}
+
 //console input variables
 const uint8_t KBD_BUFFER_SIZE = 16;//console input buffer size
 volatile char kbd_buffer[KBD_BUFFER_SIZE];//console input buffer
@@ -49,7 +64,7 @@ char con_read() {
         if (Serial.available()>0) {
           key = Serial.read();
           if (!MON && ((uint8_t)key == CTRL_SLASH_KEY)) {
-            exitFlag = true;
+            ATN |= ATN_EXIT;
           }
         } 
         break;
@@ -83,6 +83,11 @@ const uint16_t _CHK02 = _CHK01 + 16;//CHECK VECTOR 2
 const uint16_t _CHK03 = _CHK02 + 16;//CHECK VECTOR 3
 const uint16_t _ENDDAT = _CHK03 + 16;//END OF DATA AREA
 
+//BIOS TRAPS (BIOS.h)
+//TRAP, function index - one pair per BIOS vector entry (vector JMPs here), BDOS entry last
+const uint16_t _TRAPS = _ENDDAT;//BIOS traps
+const uint16_t _ENDTRAP = _TRAPS + 2 * ((_BIOS_HI - _BIOS_LO + 1) / 3 + 1);//end of BIOS traps
+
 //BOOT area
 
 #define SEC_BUF 0x80 //sector buffer
@@ -0,0 +1,236 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//DECODED BLOCK CACHE
+//straight-line runs of decoded instructions (handler, opcode, operands)
+//block ends at a branch, OUT, MMU block border or DBC_LEN instructions
+//block tag - physical address (bank, address) of the first instruction
+#define DBC_CACHE 0 //0 - off, 1 - on
+
+typedef void (*CmdFunction) ();
+extern const CmdFunction doCmdArray [] PROGMEM;
+
+//opcode info
+//bits 1..0 - instruction length
+//bit 7 - block end (JMP, Jccc, CALL, Cccc, RET, Rccc, RST, PCHL, HLT, OUT, BIOS trap)
+const uint8_t OP_LEN = B00000011;
+const uint8_t OP_END = B10000000;
+const static uint8_t PROGMEM op_info[] = {
+  0x01, 0x03, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x81, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01,
+  0x01, 0x03, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01,
+  0x01, 0x03, 0x03, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x03, 0x01, 0x01, 0x01, 0x02, 0x01,
+  0x01, 0x03, 0x03, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x03, 0x01, 0x01, 0x01, 0x02, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x81, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x81, 0x01, 0x83, 0x83, 0x83, 0x01, 0x02, 0x81, 0x81, 0x81, 0x83, 0x83, 0x83, 0x83, 0x02, 0x81,
+  0x81, 0x01, 0x83, 0x82, 0x83, 0x01, 0x02, 0x81, 0x81, 0x81, 0x83, 0x02, 0x83, 0x83, 0x02, 0x81,
+  0x81, 0x01, 0x83, 0x01, 0x83, 0x01, 0x02, 0x81, 0x81, 0x81, 0x83, 0x01, 0x83, 0x83, 0x02, 0x81,
+  0x81, 0x01, 0x83, 0x01, 0x83, 0x01, 0x02, 0x81, 0x81, 0x01, 0x83, 0x01, 0x83, 0x83, 0x02, 0x81,
+};
+
+#if DBC_CACHE
+//constants
+const uint8_t DBC_BLOCKS = 4;//blocks number
+const uint8_t DBC_LEN = 8;//instructions per block
+const uint32_t DBC_EMPTY = 0xFFFFFFFF;//empty block flag
+
+struct dbc_op_t {
+  CmdFunction fn;//handler
+  uint8_t code;//opcode
+  uint8_t len;//instruction length
+  uint8_t imm[2];//operands
+};
+
+struct dbc_block_t {
+  uint32_t tag;//physical address of the first instruction
+  uint16_t span;//block length (bytes)
+  uint8_t len;//instructions number
+  dbc_op_t op[DBC_LEN];
+};
+
+dbc_block_t dbc[DBC_BLOCKS];
+uint8_t dbc_repl = 0;//next block to replace
+dbc_block_t* dbc_blk = NULL;//current block
+uint8_t dbc_idx;//next instruction in current block
+uint16_t dbc_next;//next instruction address
+dbc_op_t* dbc_cur = NULL;//current instruction
+uint16_t dbc_pc;//current instruction address
+
+//physical address
+uint32_t dbc_phys(uint16_t adr) {
+  return ((uint32_t)(MMU_MAP[adr / MMU_BLOCK_SIZE]) << 16) | adr;
+}
+
+//drop all blocks
+void dbc_init() {
+  uint8_t i;
+  for (i = 0; i < DBC_BLOCKS; i++) {
+    dbc[i].tag = DBC_EMPTY;
+    dbc[i].span = 0;
+  }
+  dbc_blk = NULL;
+  dbc_cur = NULL;
+}
+
+//memory write - drop blocks with this address
+void dbc_wr(uint16_t adr) {
+  uint32_t phys;
+  uint8_t i;
+  phys = dbc_phys(adr);
+  for (i = 0; i < DBC_BLOCKS; i++) {
+    if ((phys - dbc[i].tag) < dbc[i].span) {
+      dbc[i].tag = DBC_EMPTY;
+      dbc[i].span = 0;
+      if (dbc_blk == &dbc[i]) {
+        dbc_blk = NULL;
+      }
+    }
+  }
+}
+
+//memory write (DMA) - drop blocks overlapping len bytes from bank:adr
+void dbc_wr_bank(uint8_t bank, uint16_t adr, uint8_t len) {
+  uint32_t phys;
+  uint8_t i;
+  phys = ((uint32_t)bank << 16) | adr;
+  for (i = 0; i < DBC_BLOCKS; i++) {
+    if (((phys - dbc[i].tag) < dbc[i].span) || ((dbc[i].tag - phys) < len)) {
+      dbc[i].tag = DBC_EMPTY;
+      dbc[i].span = 0;
+      if (dbc_blk == &dbc[i]) {
+        dbc_blk = NULL;
+      }
+    }
+  }
+}
+
+//code byte for decoding - code fetch path (fetch window, I-side),
+//line counted once as for undecoded fetches
+uint8_t dbc_byte(uint16_t adr) {
+  _AB = adr;
+  _RDCODE();
+  return _DB;
+}
+
+//decode block from adr
+dbc_block_t* dbc_fill(uint16_t adr) {
+  dbc_block_t* blk;
+  dbc_op_t* op;
+  uint16_t pc;
+  uint8_t code;
+  uint8_t info;
+  uint8_t len;
+  uint8_t n;
+  blk = &dbc[dbc_repl];
+  dbc_repl++;
+  if (dbc_repl == DBC_BLOCKS) {
+    dbc_repl = 0;
+  }
+  pc = adr;
+  n = 0;
+  do {
+    code = dbc_byte(pc);
+    info = pgm_read_byte_near(op_info + code);
+    len = info & OP_LEN;
+    if (((uint16_t)(pc + len - 1) / MMU_BLOCK_SIZE) != (adr / MMU_BLOCK_SIZE)) {
+      break;//MMU block border
+    }
+    op = &blk->op[n];
+    op->fn = (CmdFunction) pgm_read_word (&doCmdArray [code]);
+    op->code = code;
+    op->len = len;
+    if (len > 1) {
+      op->imm[0] = dbc_byte(pc + 1);
+    }
+    if (len > 2) {
+      op->imm[1] = dbc_byte(pc + 2);
+    }
+    pc = pc + len;
+    n++;
+  } while ((n < DBC_LEN) && ((info & OP_END) == 0));
+  blk->len = n;
+  if (n != 0) {
+    blk->tag = dbc_phys(adr);
+    blk->span = pc - adr;
+  }
+  else {
+    blk->tag = DBC_EMPTY;
+    blk->span = 0;
+  }
+  return blk;
+}
+
+//instruction fetch
+//address <- _PC
+//opcode -> _IR, _DB
+void dbc_fetch() {
+  uint32_t phys;
+  uint8_t i;
+  if ((dbc_blk == NULL) || (_PC != dbc_next) || (dbc_idx >= dbc_blk->len)) {
+    //block lookup
+    dbc_blk = NULL;
+    phys = dbc_phys(_PC);
+    for (i = 0; i < DBC_BLOCKS; i++) {
+      if (dbc[i].tag == phys) {
+        dbc_blk = &dbc[i];
+        break;
+      }
+    }
+    if (dbc_blk == NULL) {
+      dbc_blk = dbc_fill(_PC);
+      if (dbc_blk->len == 0) {
+        //not cacheable
+        dbc_blk = NULL;
+        dbc_cur = NULL;
+        _AB = _PC;
+        _RDCODE();
+        _IR = _DB;
+        return;
+      }
+    }
+    dbc_idx = 0;
+  }
+  dbc_cur = &dbc_blk->op[dbc_idx];
+  dbc_idx++;
+  dbc_pc = _PC;
+  dbc_next = _PC + dbc_cur->len;
+  _AB = _PC;
+  _IR = dbc_cur->code;
+  _DB = _IR;
+}
+
+//operand fetch
+//address <- _AB
+//data -> _DB
+void _FETCH() {
+  if ((dbc_cur != NULL) && ((uint16_t)(_AB - dbc_pc - 1) < (dbc_cur->len - 1))) {
+    _DB = dbc_cur->imm[_AB - dbc_pc - 1];
+  }
+  else {
+    _RDCODE();
+  }
+}
+
+#define _FETCH_START() dbc_init(); FW_BASE = FW_NONE;
+#define _FETCH_OP() dbc_fetch();
+#define _DECODE() ((dbc_cur != NULL) ? dbc_cur->fn : (CmdFunction) pgm_read_word (&doCmdArray [_IR]))
+#else
+//MEM.h calls dbc_wr before this header - function, no address needed
+void dbc_wr(uint16_t) {
+}
+
+#define dbc_wr_bank(bank, adr, len)
+#define _FETCH() _RDCODE()
+#define _FETCH_START() FW_BASE = FW_NONE;
+#define _FETCH_OP() _RDCODE(); _IR = _DB;
+#define _DECODE() ((CmdFunction) pgm_read_word (&doCmdArray [_IR]))
+#endif
@@ -0,0 +1,206 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//memory DMA controller
+//move (memmove), fill (memset), compare (memcmp) over emulated memory,
+//line by line through the cache - no i8080 instructions, no T-states
+//ports (next to FDD DMA address ports):
+//0xE6 - register select (read/write)
+//0xE7 - register data (read/write), register select + 1 after access (up to CMD)
+//registers:
+//0..1 - source address (low, high), 2 - source bank
+//3..4 - destination address (low, high), 5 - destination bank
+//       bank 0xFF - CPU address space (MMU map), 0..7 - MMU bank
+//6..7 - length (low, high), 0 - nothing to do
+//8 - fill value
+//9 - write: command, operation runs at once; read: status
+//after operation addresses and length are advanced by bytes done
+//(compare - stops at the first different byte)
+const uint8_t DMA_PORT_REG = FDD_BASE + 6;//register select
+const uint8_t DMA_PORT_DATA = FDD_BASE + 7;//register data
+
+//DMA registers
+const uint8_t DMA_SRC_LO = 0;//source address low byte
+const uint8_t DMA_SRC_HI = 1;//source address high byte
+const uint8_t DMA_SRC_BANK = 2;//source bank
+const uint8_t DMA_DST_LO = 3;//destination address low byte
+const uint8_t DMA_DST_HI = 4;//destination address high byte
+const uint8_t DMA_DST_BANK = 5;//destination bank
+const uint8_t DMA_LEN_LO = 6;//length low byte
+const uint8_t DMA_LEN_HI = 7;//length high byte
+const uint8_t DMA_VAL = 8;//fill value
+const uint8_t DMA_CMD = 9;//command/status
+const uint8_t DMA_REGS_NUM = 10;//registers number
+const uint8_t DMA_CPU = 0xFF;//bank - CPU address space
+
+//DMA commands codes
+const uint8_t DMA_MOVE_CMD = 0x00;//move (overlapping areas - as memmove)
+const uint8_t DMA_FILL_CMD = 0x01;//fill with value
+const uint8_t DMA_CMP_CMD = 0x02;//compare
+
+//DMA status
+const uint8_t DMA_OK = 0x00;//done, areas are equal (compare)
+const uint8_t DMA_NE = 0x01;//areas are different (compare)
+const uint8_t DMA_ERR = 0xFF;//bad command/bank, memory error
+
+uint8_t DMA_REG[DMA_REGS_NUM] = { 0, 0, DMA_CPU, 0, 0, DMA_CPU, 0, 0, 0, DMA_OK };//DMA registers
+uint8_t DMA_REG_SEL = 0;//register select
+
+//line of address in bank
+//returns line data, NULL - memory error
+uint8_t* dma_line(uint8_t bank, uint16_t adr) {
+  if (bank == DMA_CPU) {
+    return _mem_line(adr);
+  }
+  return _phys_line((uint16_t)bank * (uint16_t)(65536UL / CACHE_LINE_SIZE) + adr / CACHE_LINE_SIZE);
+}
+
+//bytes in line from address (down - up to line start)
+uint8_t dma_span(uint16_t adr, boolean down) {
+  if (down) {
+    return (adr & (CACHE_LINE_SIZE - 1)) + 1;
+  }
+  return CACHE_LINE_SIZE - (adr & (CACHE_LINE_SIZE - 1));
+}
+
+//registers set (fill value & command are not set)
+void dma_regs(uint8_t* reg, uint8_t sb, uint16_t src, uint8_t db, uint16_t dst, uint16_t len) {
+  reg[DMA_SRC_LO] = lowByte(src);
+  reg[DMA_SRC_HI] = highByte(src);
+  reg[DMA_SRC_BANK] = sb;
+  reg[DMA_DST_LO] = lowByte(dst);
+  reg[DMA_DST_HI] = highByte(dst);
+  reg[DMA_DST_BANK] = db;
+  reg[DMA_LEN_LO] = lowByte(len);
+  reg[DMA_LEN_HI] = highByte(len);
+}
+
+//operation run
+//reg - registers (DMA_REG or caller's own set), addresses & length updated
+//chunk - up to the nearest source/destination line border,
+//source bytes -> _dsk_buffer (destination line fill may evict source line)
+uint8_t dma_run(uint8_t* reg, uint8_t cmd) {
+  uint16_t src;
+  uint16_t dst;
+  uint16_t len;
+  uint16_t done;
+  uint16_t s;
+  uint16_t d;
+  uint8_t sb;
+  uint8_t db;
+  uint8_t n;
+  uint8_t i;
+  uint8_t res;
+  uint8_t* line;
+  boolean down;
+  src = word(reg[DMA_SRC_HI], reg[DMA_SRC_LO]);
+  dst = word(reg[DMA_DST_HI], reg[DMA_DST_LO]);
+  len = word(reg[DMA_LEN_HI], reg[DMA_LEN_LO]);
+  sb = reg[DMA_SRC_BANK];
+  db = reg[DMA_DST_BANK];
+  if ((cmd > DMA_CMP_CMD) || ((sb >= MMU_BANKS_NUM) && (sb != DMA_CPU)) || ((db >= MMU_BANKS_NUM) && (db != DMA_CPU))) {
+    return DMA_ERR;
+  }
+  //move to upper overlapping area - from the end
+  down = (cmd == DMA_MOVE_CMD) && (sb == db) && (dst != src) && ((uint16_t)(dst - src) < len);
+  res = DMA_OK;
+  done = 0;
+  while (done < len) {
+    if (down) {
+      s = src + (len - done - 1);//chunk end
+      d = dst + (len - done - 1);
+    }
+    else {
+      s = src + done;//chunk start
+      d = dst + done;
+    }
+    n = dma_span(d, down);
+    if ((cmd != DMA_FILL_CMD) && (dma_span(s, down) < n)) {
+      n = dma_span(s, down);
+    }
+    if ((len - done) < n) {
+      n = len - done;
+    }
+    if (down) {
+      s = s - (n - 1);
+      d = d - (n - 1);
+    }
+    //source chunk
+    if (cmd != DMA_FILL_CMD) {
+      line = dma_line(sb, s);
+      if (line == NULL) {
+        res = DMA_ERR;
+        break;
+      }
+      memcpy(_dsk_buffer, &line[s & (CACHE_LINE_SIZE - 1)], n);
+    }
+    //destination chunk
+    line = dma_line(db, d);
+    if (line == NULL) {
+      res = DMA_ERR;
+      break;
+    }
+    line = &line[d & (CACHE_LINE_SIZE - 1)];
+    if (cmd == DMA_CMP_CMD) {
+      for (i = 0; (i < n) && (_dsk_buffer[i] == line[i]); i++);
+      done = done + i;
+      if (i < n) {
+        res = DMA_NE;//different byte
+        break;
+      }
+      continue;
+    }
+    if (cmd == DMA_FILL_CMD) {
+      memset(line, reg[DMA_VAL], n);
+    }
+    else {
+      memcpy(line, _dsk_buffer, n);
+    }
+    sel_dirty();
+    dbc_wr_bank((db == DMA_CPU) ? MMU_MAP[d / MMU_BLOCK_SIZE] : db, d, n);//decoded code invalidation
+    done = done + n;
+  }
+  src = src + done;
+  dst = dst + done;
+  reg[DMA_SRC_LO] = lowByte(src);
+  reg[DMA_SRC_HI] = highByte(src);
+  reg[DMA_DST_LO] = lowByte(dst);
+  reg[DMA_DST_HI] = highByte(dst);
+  reg[DMA_LEN_LO] = lowByte(len - done);
+  reg[DMA_LEN_HI] = highByte(len - done);
+  return res;
+}
+
+//register read
+uint8_t dma_read() {
+  uint8_t dat;
+  dat = DMA_REG[DMA_REG_SEL];
+  if (DMA_REG_SEL < DMA_CMD) {
+    DMA_REG_SEL++;
+  }
+  return dat;
+}
+
+//register write (command register - operation run)
+void dma_write(uint8_t dat) {
+  if (DMA_REG_SEL == DMA_CMD) {
+    DMA_REG[DMA_CMD] = dma_run(DMA_REG, dat);
+  }
+  else {
+    DMA_REG[DMA_REG_SEL] = dat;
+    DMA_REG_SEL++;
+  }
+}
+
+//register select
+void dma_sel(uint8_t reg) {
+  if (reg < DMA_REGS_NUM) {
+    DMA_REG_SEL = reg;
+  }
+  else {
+    DMA_REG_SEL = DMA_CMD;
+  }
+}
@@ -9,77 +9,77 @@ const uint8_t MON_Y =  15;
 void clrscr()
 {
   Serial.write(27);       // ESC command
-  Serial.print("[2J");    // clear screen command
+  Serial.print(F("[2J"));    // clear screen command
   Serial.write(27);
-  Serial.print("[H");     // cursor to home command
+  Serial.print(F("[H"));     // cursor to home command
 }
 
 void clrlin()
 {
   Serial.write(27);       // ESC command
-  Serial.print("[2K");    // clear current line
+  Serial.print(F("[2K"));    // clear current line
 }
 
 void clrend()
 {
   Serial.write(27);       // ESC command
-  Serial.print("[K");  
+  Serial.print(F("[K"));  
 }
 
 
 void clrarea()
 {
   Serial.write(27);       // ESC command
-  Serial.print("[J");    // clear end screen
+  Serial.print(F("[J"));    // clear end screen
 }
 
 void savecur()
 {
   Serial.write(27);       // ESC command
-  Serial.print("[s");    // cursor save
+  Serial.print(F("[s"));    // cursor save
 }
 
 void loadcur()
 {
   Serial.write(27);       // ESC command
-  Serial.print("[u");    // cursor restore
+  Serial.print(F("[u"));    // cursor restore
 }
 
 void color(uint8_t clr)
 {
   Serial.write(27);       // ESC command
-  Serial.print("[");    //
+  Serial.print(F("["));    //
   switch (clr) {
-    case 0: Serial.print("30");//
+    case 0: Serial.print(F("30"));//
       break;
-    case 1: Serial.print("31");//
+    case 1: Serial.print(F("31"));//
       break;
-    case 2: Serial.print("32");//
+    case 2: Serial.print(F("32"));//
       break;
-    case 3: Serial.print("33");//
+    case 3: Serial.print(F("33"));//
       break;
-    case 4: Serial.print("34");//
+    case 4: Serial.print(F("34"));//
       break;
-    case 5: Serial.print("35");//
+    case 5: Serial.print(F("35"));//
       break;
-    case 6: Serial.print("36");//
+    case 6: Serial.print(F("36"));//
       break;
-    case 7: Serial.print("37");//
+    case 7: Serial.print(F("37"));//
       break;
-    case 8: Serial.print("38");//
+    case 8: Serial.print(F("38"));//
       break;
-    case 9: Serial.print("39");//
+    case 9: Serial.print(F("39"));//
       break;
   }
-  Serial.print("m");    //
+  Serial.print(F("m"));    //
 }
 
 void xy(uint8_t row, uint8_t col) {
   Serial.write(27);       // ESC command
-  Serial.print("[");
+  Serial.print(F("["));
   Serial.print(row, DEC);
-  Serial.print(";");    // clear screen command
+  Serial.print(F(";"));    // clear screen command
   Serial.print(col, DEC);
-  Serial.print("H");    // clear screen command
+  Serial.print(F("H"));    // clear screen command
 
 }
@@ -22,6 +22,10 @@ void _INPORT() {
       if (con_ready()) {
         dat = dat | 0x20;
         dat = dat | 0x01;
+        con_idle_cnt = 0;
+      }
+      else {
+        con_idle();
       }
       break;
     case SIOA_CON_PORT_DATA:
@@ -31,7 +35,11 @@ void _INPORT() {
           dat = uint8_t(con_read());
           readyFlag = true;
         }
+        else {
+          mem_idle();//background write-back
+        }
       } while (!readyFlag);
+      con_idle_cnt = 0;
       break;
     //SIO-2
     case SIO2_CON_PORT_STATUS:
@@ -40,6 +48,10 @@ void _INPORT() {
       dat = 0x02;
       if (con_ready()) {
         dat = dat | 0x01;
+        con_idle_cnt = 0;
+      }
+      else {
+        con_idle();
       }
       break;
     case SIO2_CON_PORT_DATA:
@@ -49,7 +61,11 @@ void _INPORT() {
           dat = uint8_t(con_read());
           readyFlag = true;
         }
+        else {
+          mem_idle();//background write-back
+        }
       } while (!readyFlag);
+      con_idle_cnt = 0;
       break;
     //FDD ports
     case FDD_PORT_CMD:
@@ -73,6 +89,13 @@ void _INPORT() {
       //drive select
       dat = FDD_REG_DRV;
       break;
+    //memory DMA controller
+    case DMA_PORT_REG:
+      dat = DMA_REG_SEL;
+      break;
+    case DMA_PORT_DATA:
+      dat = dma_read();
+      break;
     case SENSE_SW_PORT:
       //Altair/IMSAI sense switch
       dat = SENSE_SW;
@@ -84,6 +107,45 @@ void _INPORT() {
     case MMU_BANK_SEL_PORT:
       dat = bank_get(MMU_BLOCK_SEL_REG);
       break;
+    //T-states counter
+    case CLK_PORT_CNT0:
+      CYCLES_LATCH = CYCLES;
+      dat = lowByte(CYCLES_LATCH);
+      break;
+    case CLK_PORT_CNT1:
+      dat = highByte(CYCLES_LATCH);
+      break;
+    case CLK_PORT_CNT2:
+      dat = lowByte(CYCLES_LATCH >> 16);
+      break;
+    case CLK_PORT_CNT3:
+      dat = highByte(CYCLES_LATCH >> 16);
+      break;
+    case CLK_PORT_KHZ_LO:
+      dat = lowByte(CLK_KHZ);
+      break;
+    case CLK_PORT_KHZ_HI:
+      dat = highByte(CLK_KHZ);
+      break;
+    case CLK_PORT_WAIT:
+      dat = MEM_WAIT;
+      break;
+#if MEM_STAT
+    //memory statistics
+    case MST_PORT_START:
+      MST_PTR = 0;
+      MST_RESET = false;
+      dat = MST_REC_SIZE;
+      break;
+    case MST_PORT_RESET:
+      MST_PTR = 0;
+      MST_RESET = true;
+      dat = MST_REC_SIZE;
+      break;
+    case MST_PORT_DATA:
+      dat = mst_read();
+      break;
+#endif
     case IN_PORT:
       dat = digitalRead(IN_pin);
       if ((dat && 0x01) == 0x01) {
@@ -120,6 +182,12 @@ void _OUTPORT() {
     //FDD ports
     case FDD_PORT_CMD:
       //command
+#if RAM_DISK
+      if ((FDD_REG_DRV == RD_DRV) && ((dat == FDD_RD_CMD) || (dat == FDD_WRT_CMD))) {
+        FDD_REG_STATUS = rd_io(dat);//RAM disk sector
+        break;
+      }
+#endif
       if (dat == FDD_RD_CMD) {
         //sector read
         //blk = _getMEM(_FDD_SECTOR)-1;
@@ -180,6 +248,13 @@ void _OUTPORT() {
       FDD_REG_DMA = FDD_REG_DMA & 0x00FF;
       FDD_REG_DMA = FDD_REG_DMA + dat * 256;
       break;
+    //memory DMA controller
+    case DMA_PORT_REG:
+      dma_sel(dat);
+      break;
+    case DMA_PORT_DATA:
+      dma_write(dat);
+      break;
     //MMU registers
     case MMU_BLOCK_SEL_PORT:
       MMU_BLOCK_SEL_REG = dat;
@@ -187,6 +262,23 @@ void _OUTPORT() {
     case MMU_BANK_SEL_PORT:
       bank_set(MMU_BLOCK_SEL_REG,dat);
       break;
+    //T-states counter
+    case CLK_PORT_CNT0:
+      CYCLES = 0;//counter reset
+      break;
+    case CLK_PORT_KHZ_LO:
+      CLK_KHZ = CLK_KHZ & 0xFF00;
+      CLK_KHZ = CLK_KHZ | dat;
+      clk_start();
+      break;
+    case CLK_PORT_KHZ_HI:
+      CLK_KHZ = CLK_KHZ & 0x00FF;
+      CLK_KHZ = CLK_KHZ + dat * 256;
+      clk_start();
+      break;
+    case CLK_PORT_WAIT:
+      MEM_WAIT = dat;
+      break;
     case OUT_PORT:
       //bit 0 out
       if ((dat && 0x01) == 0x01) {
@@ -6,9 +6,14 @@
 
 extern boolean con_ready();
 extern char con_read();
+extern void dbc_wr(uint16_t adr);
+extern void pin_map();
 
 const uint32_t SD_MEM_OFFSET = 0x070000;//memory offset in SD-card
-boolean MEM_ERR = false;//LRC memory error flag
+boolean MEM_ERR = false;//memory error flag (LRC, SD read)
+//swap area generation (boot counter, EEPROM)
+//line of another generation - never written since power-up, reads as zeros
+uint16_t SWAP_GEN = 1;
 
 const static uint8_t PROGMEM memtest_table[] = {
   0x3D, 0x55, 0x5F, 0x15, 0x23, 0x47, 0x1C, 0x31, 0x48, 0x60, 0x35, 0x11, 0x4F, 0x2F, 0x2E, 0x14, 0x20, 0x5B, 0x39, 0x26, 0x09, 0x61, 0x34, 0x30, 0x50, 0x2B, 0x4B, 0x0F, 0x63, 0x1F, 0x10, 0x1E, 0x36,
@@ -16,35 +21,922 @@ const static uint8_t PROGMEM memtest_table[] = {
 const uint16_t MEMTEST_TABLE_SIZE = 33;
 uint8_t RAM_TEST_MODE;//memory check mpde
 
-//CACHE
-//constants
-const uint16_t CACHE_LINE_SIZE = 64;//cache line size
-const uint8_t CACHE_LINES_NUM = 8;//cache lines number
-const uint16_t CACHE_SIZE = CACHE_LINES_NUM * CACHE_LINE_SIZE;//total cache size
-const uint32_t CACHE_LINE_EMPTY = 0xFFFFFFFF;//empty cache line flag
-//arrays
-static uint8_t cache[CACHE_SIZE];//cache
-uint32_t cache_tag[CACHE_LINES_NUM];//cache line tag (block #)
-uint16_t cache_start[CACHE_LINES_NUM];//cache line start
-boolean cache_dirty[CACHE_LINES_NUM];//cache line dirty flag
+//FETCH WINDOW
+//cache line of the last code fetch - sequential fetches skip the tag search
+//window points to cache data, so writes to the line are seen at once;
+//invalidated on cache line fill (line data slot reuse) and MMU map change
+const uint16_t FW_NONE = 0xFFFF;//empty window (not a line start)
+uint16_t FW_BASE = FW_NONE;//window line start address
+uint8_t* FW_PTR;//window line data
 
 //MMU
 //ports
 const uint8_t MMU_BLOCK_SEL_PORT = 0xD0;//block select port
 const uint8_t MMU_BANK_SEL_PORT = 0xD1;//bank select port
-//registers
-uint8_t MMU_BLOCK_SEL_REG = 0x00;//block select register
-uint8_t MMU_BANK_SEL_REG = 0x00;//bank register
 //constants
 const uint8_t MMU_BANKS_NUM = 8;//banks number
 const uint16_t MMU_BLOCK_SIZE = 4096;//4096 bytes - block size 
 const uint8_t MMU_BLOCKS_NUM = 65536UL / MMU_BLOCK_SIZE;//blocks number
-//map
-uint8_t MMU_MAP[MMU_BLOCKS_NUM];//memory banking map
+
+//MEMORY STATISTICS
+//cache hits & misses - cache counters (CACHE_SPLIT - both sides)
+//misses per bank & per 4K CPU block - 16 bits, saturated
+//ports (read only):
+//0xD8 - record start, returns record length
+//0xD9 - record start, counters reset after the last record byte (reset on read)
+//0xDA - next record byte (32-bit counters latched on their first byte):
+//       hits, misses, lines written back, SD reads, SD writes, LRC errors, SD time (us) - 32 bits,
+//       misses per bank - 8 x 16 bits, misses per 4K CPU block - 16 x 16 bits (low byte first)
+//counters & port record state - 74 bytes of SRAM
+#define MEM_STAT 1
+const uint8_t MST_BASE = 0xD8;//statistics base address
+const uint8_t MST_PORT_START = MST_BASE + 0;//record start
+const uint8_t MST_PORT_RESET = MST_BASE + 1;//record start, reset on read
+const uint8_t MST_PORT_DATA = MST_BASE + 2;//record data
+const uint8_t MST_CNT_NUM = 7;//32-bit counters number
+const uint8_t MST_REC_SIZE = MST_CNT_NUM * 4 + (MMU_BANKS_NUM + MMU_BLOCKS_NUM) * 2;//record length
+#if MEM_STAT
+uint32_t MST_WB = 0;//lines written back counter
+uint32_t MST_SD_RD = 0;//SD reads counter
+uint32_t MST_SD_WR = 0;//SD writes counter
+uint32_t MST_LRC = 0;//LRC errors counter
+uint32_t MST_SD_US = 0;//SD time, us
+uint16_t MST_BANK[MMU_BANKS_NUM];//misses per bank
+uint16_t MST_BLK[MMU_BLOCKS_NUM];//misses per CPU block
+uint8_t MST_PTR = MST_REC_SIZE;//record byte pointer
+bool MST_RESET = false;//reset after record
+uint32_t MST_LATCH;//32-bit counter latch
+#endif
+
+//CACHE
+//set-associative, geometry - template parameters (sets x ways x line size)
+//set - low bits of physical line #, lookup - WAYS tag compares
+//line in SD-card: line data + LRC + generation (2 bytes, low byte first)
+//(line size + 3 <= SD_BLK_SIZE, ways <= 8)
+//SD_PACK - SD_SEC_SIZE / (line size + 3) lines per sector, line # / lines - sector,
+//line # % lines - slot; write-back merges all dirty cached lines of the sector
+//no SD_PACK - line # = block #; dirty lines stay cached until eviction, then
+//the run of dirty cached lines in adjacent blocks goes out in one multi-block write
+const uint16_t CACHE_LINE_SIZE = 64;//cache line size
+const uint8_t CACHE_SETS = 2;//sets number
+const uint8_t CACHE_WAYS = 4;//ways number
+const uint8_t CACHE_LINES_NUM = CACHE_SETS * CACHE_WAYS;//cache lines number
+const uint16_t CACHE_SIZE = CACHE_LINES_NUM * CACHE_LINE_SIZE;//total cache size
+const uint16_t CACHE_LINE_EMPTY = 0xFFFF;//empty cache line tag
+const uint8_t CACHE_ERR = 0xFF;//line fill error
+//replacement policy (per set)
+//FIFO - round robin
+//CLOCK - second chance, reference bit set by hit
+//2Q - segmented: hit moves a line to the protected part (up to WAYS/2 lines),
+//     probation lines are replaced first
+//hits to the last accessed line (byte sweeps) are not references
+const uint8_t CACHE_FIFO = 0;
+const uint8_t CACHE_CLOCK = 1;
+const uint8_t CACHE_2Q = 2;
+const uint8_t CACHE_POLICIES_NUM = 3;
+const uint8_t CACHE_POLICY = CACHE_2Q;//default policy
+//sequential prefetch
+//miss on the line after the last missed one, or hit on a prefetched line -
+//next line fill (not across 4K MMU block); prefetched line - probation
+//accuracy - prefetched lines used, pollution - evicted unused
+const bool CACHE_PREFETCH = true;//default prefetch mode
+//split I/D cache
+//1 - code fetches (opcodes & operands) - I-side, other accesses - D-side,
+//    each side - CACHE_SETS x CACHE_WAYS / 2 lines (CACHE_WAYS - even);
+//    miss looks up the other side before fill, so a line is cached in one side only
+//    and writes to code lines update the single copy; hits & misses counted per side
+//0 - one cache
+#define CACHE_SPLIT 0
+#if CACHE_SPLIT
+const uint8_t CACHE_SIDE_WAYS = CACHE_WAYS / 2;//ways per side
+#else
+const uint8_t CACHE_SIDE_WAYS = CACHE_WAYS;
+#endif
+const uint8_t CACHE_PEER = 0x80;//line index flag - line in the other side
+
+//L2 - SPI SRAM (23K256) between the line cache and SD card
+//victim tier: lines evicted from the cache (dirty ones are written back to SD first),
+//miss looks up L2 before SD; direct mapped, slot - line tag + line data
+//SPI bus shared with SD card, SD partial block read ended before L2 access
+#define L2_SPIRAM 0
+#if L2_SPIRAM
+const uint8_t L2_SS_pin = 6;//SS pin (D6)
+const uint16_t L2_SIZE = 32768;//SPI SRAM size
+const uint16_t L2_SLOT_SIZE = 2 + CACHE_LINE_SIZE;//tag + line
+const uint16_t L2_SLOTS_NUM = L2_SIZE / L2_SLOT_SIZE;//slots number
+SpiRAM L2RAM(RAMCLK4M, L2_SS_pin);
+uint32_t L2_HITS = 0;//L2 hits counter
+uint32_t L2_MISSES = 0;//L2 misses counter
+
+//all L2 slots empty
+void l2_init() {
+  uint16_t i;
+  uint16_t tag;
+  tag = CACHE_LINE_EMPTY;
+  card.readEnd();//SD deselect
+  for (i = 0; i < L2_SLOTS_NUM; i++) {
+    L2RAM.write_stream(i * L2_SLOT_SIZE, (char*)&tag, 2);
+  }
+}
+
+//line lookup in L2
+//returns true - line data read
+bool l2_get(uint16_t tag, uint8_t* line) {
+  uint16_t adr;
+  uint16_t slot_tag;
+  card.readEnd();//SD deselect
+  adr = (tag % L2_SLOTS_NUM) * L2_SLOT_SIZE;
+  L2RAM.read_stream(adr, (char*)&slot_tag, 2);
+  if (slot_tag != tag) {
+    L2_MISSES++;
+    return false;
+  }
+  L2RAM.read_stream(adr + 2, (char*)line, CACHE_LINE_SIZE);
+  L2_HITS++;
+  return true;
+}
+
+//line -> L2
+void l2_put(uint16_t tag, uint8_t* line) {
+  uint16_t adr;
+  card.readEnd();//SD deselect
+  adr = (tag % L2_SLOTS_NUM) * L2_SLOT_SIZE;
+  L2RAM.write_stream(adr, (char*)&tag, 2);
+  L2RAM.write_stream(adr + 2, (char*)line, CACHE_LINE_SIZE);
+}
+#endif
+
+//VICTIM BUFFER
+//last lines evicted from the cache (both sides), clean or dirty - write-back deferred
+//miss looks up the buffer before L2/SD: line swapped back with the evicted one, no SD I/O;
+//oldest buffer line pushed out - written back if dirty, then L2
+//VICTIM_NUM - lines number, CACHE_LINE_SIZE + 2 bytes of SRAM each (0 - none, <= 8)
+//CP/M session (host), 0 / 1 / 2 / 4 lines: misses hit in the buffer - 0 / 12 / 25 / 41%,
+//SD reads 8192 / 7766 / 7289 / 6665, SD write commands 901 / 767 / 644 / 482
+#define VICTIM_NUM 2
+#if VICTIM_NUM
+uint16_t VB_TAG[VICTIM_NUM];//line tags (CACHE_LINE_EMPTY - empty)
+uint8_t VB_DATA[VICTIM_NUM][CACHE_LINE_SIZE];//lines data
+uint8_t VB_DIRTY = 0;//dirty flags, bit per line
+uint8_t VB_NEXT = 0;//next line to push out
+uint32_t VB_HITS = 0;//hits counter
+
+//line lookup
+//returns buffer line #, CACHE_ERR - not in buffer
+uint8_t vb_find(uint16_t tag) {
+  uint8_t v;
+  for (v = 0; v < VICTIM_NUM; v++) {
+    if (VB_TAG[v] == tag) {
+      return v;
+    }
+  }
+  return CACHE_ERR;
+}
+#endif
+
+template <uint8_t SETS, uint8_t WAYS, uint16_t LINE>
+struct cache_t {
+  struct set_t {
+    uint16_t tag[WAYS];//line tag (physical line #)
+    uint8_t dirty;//dirty flags, bit per way
+    uint8_t ref;//CLOCK - reference bits, 2Q - protected bits
+    uint8_t pf;//prefetched, not used yet flags
+    uint8_t next;//replacement hand
+  };
+  set_t set[SETS];
+  uint8_t data[SETS * WAYS * LINE];
+  uint8_t policy;//replacement policy
+  bool prefetch;//sequential prefetch on
+  uint8_t last;//last accessed line
+  uint16_t last_miss;//last missed line tag
+  uint32_t hits;//hits counter
+  uint32_t misses;//misses counter
+  uint32_t pf_issued;//prefetched lines counter
+  uint32_t pf_used;//prefetched lines used counter
+  uint32_t pf_wasted;//prefetched lines evicted unused counter
+  cache_t* peer;//other side (CACHE_SPLIT), NULL - none
+  static const uint8_t PACK = SD_SEC_SIZE / (LINE + 3);//lines per SD sector (SD_PACK)
+
+  //all lines empty
+  void init() {
+    uint8_t s;
+    uint8_t w;
+    for (s = 0; s < SETS; s++) {
+      for (w = 0; w < WAYS; w++) {
+        set[s].tag[w] = CACHE_LINE_EMPTY;
+      }
+      set[s].dirty = 0;
+      set[s].ref = 0;
+      set[s].pf = 0;
+      set[s].next = 0;
+    }
+    last = CACHE_ERR;
+    last_miss = CACHE_LINE_EMPTY;
+    stat_reset();
+  }
+
+  //statistics reset
+  void stat_reset() {
+    hits = 0;
+    misses = 0;
+    pf_issued = 0;
+    pf_used = 0;
+    pf_wasted = 0;
+  }
+
+  //line data
+  uint8_t* ptr(uint8_t idx) {
+    return &data[idx * LINE];
+  }
+
+  //line written
+  void dirty(uint8_t idx) {
+    set[idx / WAYS].dirty |= (1 << (idx % WAYS));
+  }
+
+  //line written back
+  void clean(uint8_t idx) {
+    set[idx / WAYS].dirty &= ~(1 << (idx % WAYS));
+  }
+
+  //dirty line lookup, no fill
+  //returns line index, CACHE_ERR - not cached or clean
+  uint8_t find_dirty(uint16_t tag) {
+    uint8_t s;
+    uint8_t w;
+    s = tag % SETS;
+    for (w = 0; w < WAYS; w++) {
+      if ((set[s].tag[w] == tag) && (set[s].dirty & (1 << w))) {
+        return s * WAYS + w;
+      }
+    }
+    return CACHE_ERR;
+  }
+
+  //line lookup, no fill, no counters
+  //returns line index, CACHE_ERR - not cached
+  uint8_t probe(uint16_t tag) {
+    uint8_t s;
+    uint8_t w;
+    s = tag % SETS;
+    for (w = 0; w < WAYS; w++) {
+      if (set[s].tag[w] == tag) {
+        return s * WAYS + w;
+      }
+    }
+    return CACHE_ERR;
+  }
+
+  //line lookup, miss - other side lookup, line fill
+  //tag - physical line #
+  //returns line index (set * WAYS + way), CACHE_PEER | index - line in other side,
+  //CACHE_ERR - memory error
+  uint8_t find(uint16_t tag) {
+    uint8_t s;
+    uint8_t w;
+    uint8_t idx;
+    bool pf;
+    s = tag % SETS;
+    for (w = 0; w < WAYS; w++) {
+      if (set[s].tag[w] == tag) {
+        hits++;
+        idx = s * WAYS + w;
+        if (idx != last) {
+          touch(s, w);
+          last = idx;
+        }
+        if (set[s].pf & (1 << w)) {
+          //stream goes on
+          set[s].pf &= ~(1 << w);
+          pf_used++;
+          if (prefetch && next_ok(tag)) {
+            prefetch_line(tag + 1);
+          }
+        }
+        return idx;
+      }
+    }
+    if (peer != NULL) {
+      idx = peer->probe(tag);
+      if (idx != CACHE_ERR) {
+        hits++;
+        return CACHE_PEER | idx;
+      }
+    }
+    misses++;
+#if MEM_STAT
+    if (MST_BANK[tag / (65536UL / LINE)] != 0xFFFF) {
+      MST_BANK[tag / (65536UL / LINE)]++;
+    }
+#endif
+    pf = prefetch && (tag == (last_miss + 1)) && next_ok(tag);
+    last_miss = tag;
+#if SD_PACK
+    if (pf && (((tag + 1) % PACK) != 0)) {
+      readKeepSD(true);//next slot - same sector read goes on
+    }
+#endif
+    last = fill(s, tag);
+    if (pf && (last != CACHE_ERR)) {
+      prefetch_line(tag + 1);
+    }
+#if SD_PACK
+    readKeepSD(false);
+#endif
+    return last;
+  }
+
+  //next line may be prefetched
+  //(own set, same MMU block)
+  bool next_ok(uint16_t tag) {
+    return (SETS > 1) && (((tag + 1) % (4096 / LINE)) != 0);
+  }
+
+  //line prefetch, if not cached
+  void prefetch_line(uint16_t tag) {
+    uint8_t s;
+    uint8_t w;
+    uint8_t idx;
+    s = tag % SETS;
+    for (w = 0; w < WAYS; w++) {
+      if (set[s].tag[w] == tag) {
+        return;
+      }
+    }
+    if ((peer != NULL) && (peer->probe(tag) != CACHE_ERR)) {
+      return;
+    }
+    idx = fill(s, tag);
+    if (idx != CACHE_ERR) {
+      set[s].pf |= (1 << (idx % WAYS));
+      pf_issued++;
+    }
+  }
+
+  //line reference
+  void touch(uint8_t s, uint8_t w) {
+    uint8_t i;
+    uint8_t v;
+    switch (policy) {
+      case CACHE_CLOCK:
+        set[s].ref |= (1 << w);
+        break;
+      case CACHE_2Q:
+        if ((set[s].ref & (1 << w)) == 0) {
+          //probation -> protected
+          set[s].ref |= (1 << w);
+          if (protected_num(s) > (WAYS / 2)) {
+            //protected part full - oldest other line back to probation
+            v = set[s].next;
+            for (i = 0; i < WAYS; i++) {
+              if ((v != w) && (set[s].ref & (1 << v))) {
+                set[s].ref &= ~(1 << v);
+                break;
+              }
+              v = (v + 1) % WAYS;
+            }
+          }
+        }
+        break;
+    }
+  }
+
+  //protected lines number
+  uint8_t protected_num(uint8_t s) {
+    uint8_t w;
+    uint8_t n;
+    n = 0;
+    for (w = 0; w < WAYS; w++) {
+      if (set[s].ref & (1 << w)) {
+        n++;
+      }
+    }
+    return n;
+  }
+
+  //way to replace
+  uint8_t victim(uint8_t s) {
+    uint8_t w;
+    uint8_t i;
+    w = set[s].next;
+    switch (policy) {
+      case CACHE_CLOCK:
+        //second chance
+        while (set[s].ref & (1 << w)) {
+          set[s].ref &= ~(1 << w);
+          w = (w + 1) % WAYS;
+        }
+        break;
+      case CACHE_2Q:
+        //first probation line
+        for (i = 0; i < WAYS; i++) {
+          if ((set[s].ref & (1 << w)) == 0) {
+            break;
+          }
+          w = (w + 1) % WAYS;
+        }
+        break;
+    }
+    set[s].next = (w + 1) % WAYS;
+    set[s].ref &= ~(1 << w);
+    return w;
+  }
+
+  //line + LRC + generation -> _buffer
+  void pack(uint8_t idx, uint16_t pos) {
+    pack_line(ptr(idx), pos);
+  }
+
+  //line data + LRC + generation -> _buffer
+  void pack_line(uint8_t* line, uint16_t pos) {
+    uint16_t i;
+    uint8_t LRC;
+#if MEM_STAT
+    MST_WB++;
+#endif
+    LRC = 0;//LRC reset
+    for (i = 0; i < LINE; i++) {
+      _buffer[pos + i] = line[i];
+      LRC = line[i] ^ LRC;//LRC calculation
+    }
+    _buffer[pos + LINE] = LRC;//LRC add
+    _buffer[pos + LINE + 1] = lowByte(SWAP_GEN);
+    _buffer[pos + LINE + 2] = highByte(SWAP_GEN);
+  }
+
+#if SD_PACK
+  //sector read/modify/write: all dirty lines of the sector (cache & victim buffer) -> SD
+  void write_sec(uint16_t sec) {
+    uint8_t res;
+    uint16_t tag;
+    uint8_t i;
+    uint8_t j;
+    res = readPartSD(sec + SD_MEM_OFFSET, 0, SD_SEC_SIZE);
+#if MEM_STAT
+    MST_SD_RD++;
+#endif
+    if (res == 0) {
+      //SD read error - sector not rewritten (other lines kept), memory error
+      MEM_ERR = true;
+      ATN |= ATN_EXIT;//quit to monitor
+      return;
+    }
+    for (i = 0; i < SETS; i++) {
+      for (j = 0; j < WAYS; j++) {
+        tag = set[i].tag[j];
+        if ((tag != CACHE_LINE_EMPTY) && (set[i].dirty & (1 << j)) && ((tag / PACK) == sec)) {
+          pack(i * WAYS + j, (tag % PACK) * (LINE + 3));
+          clean(i * WAYS + j);
+        }
+      }
+    }
+#if VICTIM_NUM
+    for (i = 0; i < VICTIM_NUM; i++) {
+      if ((VB_DIRTY & (1 << i)) && ((VB_TAG[i] / PACK) == sec)) {
+        pack_line(VB_DATA[i], (VB_TAG[i] % PACK) * (LINE + 3));
+        VB_DIRTY &= ~(1 << i);
+      }
+    }
+#endif
+    res = writeSecSD(sec + SD_MEM_OFFSET);
+#if MEM_STAT
+    MST_SD_WR++;
+#endif
+  }
+#endif
+
+#if !SD_PACK
+  //dirty line data by tag - cache or victim buffer
+  //returns line data, NULL - not dirty
+  uint8_t* dirty_data(uint16_t tag) {
+    uint8_t idx;
+    idx = find_dirty(tag);
+    if (idx != CACHE_ERR) {
+      return ptr(idx);
+    }
+#if VICTIM_NUM
+    uint8_t v;
+    for (v = 0; v < VICTIM_NUM; v++) {
+      if ((VB_TAG[v] == tag) && (VB_DIRTY & (1 << v))) {
+        return VB_DATA[v];
+      }
+    }
+#endif
+    return NULL;
+  }
+
+  //dirty line by tag written back - cache or victim buffer
+  void dirty_clean(uint16_t tag) {
+    uint8_t idx;
+    idx = find_dirty(tag);
+    if (idx != CACHE_ERR) {
+      clean(idx);
+      return;
+    }
+#if VICTIM_NUM
+    uint8_t v;
+    for (v = 0; v < VICTIM_NUM; v++) {
+      if (VB_TAG[v] == tag) {
+        VB_DIRTY &= ~(1 << v);
+      }
+    }
+#endif
+  }
+
+  //run of dirty lines in adjacent blocks (cache & victim buffer) around tag -> SD
+  void write_run(uint16_t tag) {
+    uint8_t res;
+    uint8_t i;
+    uint8_t n;
+#if MEM_STAT
+    MST_SD_WR++;
+#endif
+    while ((tag > 0) && (dirty_data(tag - 1) != NULL)) {
+      tag--;
+    }
+    n = 1;
+    while (dirty_data(tag + n) != NULL) {
+      n++;
+    }
+    if (n == 1) {
+      pack_line(dirty_data(tag), 0);
+      res = writeSD(tag + SD_MEM_OFFSET);
+      dirty_clean(tag);
+      return;
+    }
+    res = writeStartSD(tag + SD_MEM_OFFSET, n);
+    for (i = 0; i < n; i++) {
+      pack_line(dirty_data(tag + i), 0);
+      res = writeNextSD();
+      dirty_clean(tag + i);
+    }
+    res = writeStopSD();
+  }
+#endif
+
+  //dirty line -> SD
+  void write_back(uint8_t s, uint8_t w) {
+#if SD_PACK
+    write_sec(set[s].tag[w] / PACK);
+#else
+    write_run(set[s].tag[w]);
+#endif
+  }
+
+#if VICTIM_NUM
+  //dirty victim buffer line -> SD
+  void vb_write_back(uint8_t v) {
+#if SD_PACK
+    write_sec(VB_TAG[v] / PACK);
+#else
+    write_run(VB_TAG[v]);
+#endif
+  }
+#endif
+
+  //one dirty line -> SD, line stays cached (background write-back)
+  //returns false - no dirty lines
+  bool flush_one() {
+    uint8_t s;
+    uint8_t w;
+    for (s = 0; s < SETS; s++) {
+      if (set[s].dirty) {
+        for (w = 0; w < WAYS; w++) {
+          if (set[s].dirty & (1 << w)) {
+            write_back(s, w);
+            return true;
+          }
+        }
+      }
+    }
+#if VICTIM_NUM
+    for (w = 0; w < VICTIM_NUM; w++) {
+      if (VB_DIRTY & (1 << w)) {
+        vb_write_back(w);
+        return true;
+      }
+    }
+#endif
+    return false;
+  }
+
+  //line fill from SD, dirty victim -> SD
+  uint8_t fill(uint8_t s, uint16_t tag) {
+    uint8_t w;
+    uint8_t idx;
+    uint8_t* line;
+    uint16_t i;
+    uint8_t res;
+    uint8_t LRC;
+#if MEM_STAT
+    uint32_t t0;
+#endif
+#if VICTIM_NUM
+    uint8_t v;
+    uint8_t d;
+#endif
+    FW_BASE = FW_NONE;//fetch window invalidation
+    w = victim(s);
+    idx = s * WAYS + w;
+    line = ptr(idx);
+    if (set[s].pf & (1 << w)) {
+      pf_wasted++;//prefetch pollution
+      set[s].pf &= ~(1 << w);
+    }
+#if VICTIM_NUM
+    v = vb_find(tag);
+    if (v != CACHE_ERR) {
+      //victim buffer hit - line swap
+      VB_HITS++;
+      for (i = 0; i < LINE; i++) {
+        d = line[i];
+        line[i] = VB_DATA[v][i];
+        VB_DATA[v][i] = d;
+      }
+      d = VB_DIRTY & (1 << v);
+      VB_TAG[v] = set[s].tag[w];
+      VB_DIRTY &= ~(1 << v);
+      if ((set[s].tag[w] != CACHE_LINE_EMPTY) && (set[s].dirty & (1 << w))) {
+        VB_DIRTY |= (1 << v);
+      }
+      set[s].tag[w] = tag;
+      set[s].dirty &= ~(1 << w);
+      if (d) {
+        set[s].dirty |= (1 << w);
+      }
+      return idx;
+    }
+    if (set[s].tag[w] != CACHE_LINE_EMPTY) {
+      //evicted line -> victim buffer, oldest buffer line out
+      v = VB_NEXT;
+      VB_NEXT = (v + 1) % VICTIM_NUM;
+      if (VB_TAG[v] != CACHE_LINE_EMPTY) {
+        if (VB_DIRTY & (1 << v)) {
+#if MEM_STAT
+          t0 = micros();
+          vb_write_back(v);
+          MST_SD_US += micros() - t0;
+#else
+          vb_write_back(v);
+#endif
+        }
+#if L2_SPIRAM
+        l2_put(VB_TAG[v], VB_DATA[v]);//buffer victim -> L2
+#endif
+      }
+      for (i = 0; i < LINE; i++) {
+        VB_DATA[v][i] = line[i];
+      }
+      VB_TAG[v] = set[s].tag[w];
+      if (set[s].dirty & (1 << w)) {
+        VB_DIRTY |= (1 << v);
+      }
+      set[s].tag[w] = CACHE_LINE_EMPTY;
+      set[s].dirty &= ~(1 << w);
+    }
+#endif
+    if ((set[s].tag[w] != CACHE_LINE_EMPTY) && (set[s].dirty & (1 << w))) {
+#if MEM_STAT
+      t0 = micros();
+      write_back(s, w);
+      MST_SD_US += micros() - t0;
+#else
+      write_back(s, w);
+#endif
+    }
+    set[s].dirty &= ~(1 << w);
+#if L2_SPIRAM
+    if (set[s].tag[w] != CACHE_LINE_EMPTY) {
+      l2_put(set[s].tag[w], line);//victim -> L2
+    }
+    if (l2_get(tag, line)) {
+      set[s].tag[w] = tag;
+      return idx;
+    }
+#endif
+    //read new line from SD
+#if MEM_STAT
+    t0 = micros();
+#endif
+#if SD_PACK
+    res = readPartSD(tag / PACK + SD_MEM_OFFSET, (tag % PACK) * (LINE + 3), LINE + 3);
+#else
+    res = readSD(tag + SD_MEM_OFFSET, 0);
+#endif
+#if MEM_STAT
+    MST_SD_US += micros() - t0;
+    MST_SD_RD++;
+#endif
+    if (res == 0) {
+      //SD read error - line not valid
+      set[s].tag[w] = CACHE_LINE_EMPTY;
+      MEM_ERR = true;
+      ATN |= ATN_EXIT;//quit to monitor
+      return CACHE_ERR;
+    }
+    if (word(_buffer[LINE + 2], _buffer[LINE + 1]) != SWAP_GEN) {
+      //not written yet - zeros
+      for (i = 0; i < LINE; i++) {
+        line[i] = 0;
+      }
+      set[s].tag[w] = tag;
+      return idx;
+    }
+    LRC = 0;//LRC reset
+    for (i = 0; i < LINE; i++) {
+      line[i] = _buffer[i];
+      LRC = _buffer[i] ^ LRC;//LRC calculation
+    }
+    if (_buffer[LINE] != LRC) {
+#if MEM_STAT
+      MST_LRC++;
+#endif
+      set[s].tag[w] = CACHE_LINE_EMPTY;
+      MEM_ERR = true;
+      ATN |= ATN_EXIT;//quit to monitor
+      return CACHE_ERR;
+    }
+    set[s].tag[w] = tag;
+    return idx;
+  }
+};
+
+//every member given: sets, data, policy, prefetch, last, last_miss, counters, peer (split sides linked at init)
+cache_t<CACHE_SETS, CACHE_SIDE_WAYS, CACHE_LINE_SIZE> CACHE = { {}, {}, CACHE_POLICY, CACHE_PREFETCH, CACHE_ERR, CACHE_LINE_EMPTY, 0, 0, 0, 0, 0, NULL };//emulator RAM cache (D-side)
+#if CACHE_SPLIT
+cache_t<CACHE_SETS, CACHE_SIDE_WAYS, CACHE_LINE_SIZE> ICACHE = { {}, {}, CACHE_POLICY, CACHE_PREFETCH, CACHE_ERR, CACHE_LINE_EMPTY, 0, 0, 0, 0, 0, NULL };//I-side
+#endif
+uint8_t cache_sel;//last accessed cache line (CACHE_PEER - I-side, CACHE_ERR - pinned line)
+
+//all lines empty
+void cache_init() {
+#if VICTIM_NUM
+  uint8_t v;
+  for (v = 0; v < VICTIM_NUM; v++) {
+    VB_TAG[v] = CACHE_LINE_EMPTY;
+  }
+  VB_DIRTY = 0;
+#endif
+  CACHE.init();
+#if CACHE_SPLIT
+  ICACHE.init();
+  CACHE.peer = &ICACHE;
+  ICACHE.peer = &CACHE;
+#endif
+}
+uint8_t* line_sel;//last accessed line data
+
+//RAM swap area size (SD blocks)
+#if SD_PACK
+const uint8_t SWAP_SEC_LINES = SD_SEC_SIZE / (CACHE_LINE_SIZE + 3);//lines per sector
+const uint32_t SWAP_BLOCKS_NUM = (65536UL / CACHE_LINE_SIZE * MMU_BANKS_NUM + SWAP_SEC_LINES - 1) / SWAP_SEC_LINES;
+#else
+const uint32_t SWAP_BLOCKS_NUM = 65536UL / CACHE_LINE_SIZE * MMU_BANKS_NUM;
+#endif
+
+//RAM swap area header - SD block after the swap area:
+//0x55, 0xAA, generation (low byte first); generation kept on the card,
+//so EEPROM reset or the card moved to another board can't revive old lines
+const uint32_t SWAP_HDR_BLK = SD_MEM_OFFSET + SWAP_BLOCKS_NUM;
+
+//next swap generation - newer of card header & gen (EEPROM) + 1, header written
+//no header (new card), header read error or generation wrap - swap area erased
+//(blank patterns never match)
+//returns 0 - SD error (erase or header write failed), stale lines not ruled out
+uint16_t swap_gen_next(uint16_t gen) {
+  uint8_t res;
+  bool blank;
+  res = readSD(SWAP_HDR_BLK, 0);
+  blank = (res == 0) || !((_buffer[0] == 0x55) && (_buffer[1] == 0xAA));
+  if ((!blank) && (word(_buffer[3], _buffer[2]) > gen)) {
+    gen = word(_buffer[3], _buffer[2]);
+  }
+  gen++;
+  if ((gen == 0x0000) || (gen == 0xFFFF)) {
+    gen = 1;//blank SD-card patterns skipped
+    blank = true;
+  }
+  if (blank) {
+    res = eraseSD(SD_MEM_OFFSET, SWAP_BLOCKS_NUM);
+    if (res == 0) {
+      return 0;
+    }
+  }
+  memset(_buffer, 0, SD_BLK_SIZE);
+  _buffer[0] = 0x55;
+  _buffer[1] = 0xAA;
+  _buffer[2] = lowByte(gen);
+  _buffer[3] = highByte(gen);
+  res = writeSD(SWAP_HDR_BLK);
+  if (res == 0) {
+    return 0;
+  }
+  return gen;
+}
+
+//PINNED LINES
+//lines kept in SRAM for good - no cache lookup, never swapped to SD
+//line - physical line # (bank * 65536 + address) / CACHE_LINE_SIZE, so pinned
+//lines follow MMU bank switching
+//PIN_NUM - pinned lines number, CACHE_LINE_SIZE bytes of SRAM each (0 - none)
+//CP/M session (host), 0 / 2 lines: cache misses 4195 / 3682, SD reads 8720 / 8192
+#define PIN_NUM 2
+#if PIN_NUM
+const uint16_t PIN_TAG[PIN_NUM] = {
+  (0 * 65536UL + JMP_BOOT) / CACHE_LINE_SIZE,//bank 0 page zero: JMP BOOT, IOBYTE, JMP BDOS
+  (0 * 65536UL + _BIOS) / CACHE_LINE_SIZE,//bank 0 BIOS jump table
+  //(0 * 65536UL + 0x0080) / CACHE_LINE_SIZE,//bank 0 default DMA buffer (first half)
+  //(0 * 65536UL + SP_INIT - 1) / CACHE_LINE_SIZE,//bank 0 CCP stack
+};
+uint8_t PIN_DATA[PIN_NUM][CACHE_LINE_SIZE];//pinned lines data
+#endif
+uint16_t PIN_BLK = 0;//CPU blocks with pinned lines mapped, bit per block
+
+//MACHINE STATE
+//CPU registers, bus & MMU of the emulated machine
+//not volatile - no ISR access, registers may stay in CPU registers
+struct machine_t {
+  uint16_t PC;//program counter
+  uint16_t SPR;//stack pointer (SP - AVR register macro)
+  uint8_t IR;//instruction register
+  uint8_t W;//W register
+  uint8_t Z;//Z register
+  uint8_t ACT;//ACT register
+  uint8_t TMP;//TMP register
+  uint8_t ALU;//ALU
+  uint8_t Regs[8];//B, C, D, E, H, L, F, A
+  uint8_t LF_OP;//last ALU operation kind (lazy flags)
+  uint8_t LF_A;//accumulator operand
+  uint8_t LF_B;//second operand
+  uint8_t LF_R;//result
+  bool INTE;//interrupts enable
+  uint16_t AB;//address bus
+  uint8_t DB;//data bus
+  uint8_t MMU_BLOCK_SEL_REG;//block select register
+  uint8_t MMU_MAP[MMU_BLOCKS_NUM];//memory banking map
+  uint16_t MMU_BASE[MMU_BLOCKS_NUM];//physical line # base per block (bank * lines per bank)
+};
+//machines number
+//1 - direct access (AVR)
+//>1 - host build, current machine selected by machine_sel()
+//     (memory cache & SD-card area are shared - use different banks)
+#define MACHINES_NUM 1
+machine_t MACHINE[MACHINES_NUM];
+#if MACHINES_NUM > 1
+machine_t* _MP = &MACHINE[0];//current machine
+#define _M (*_MP)
+void machine_sel(uint8_t n) {
+  _MP = &MACHINE[n];
+  FW_BASE = FW_NONE;//fetch window invalidation
+  pin_map();
+}
+#else
+#define _M MACHINE[0]
+#endif
+//state access
+#define _PC _M.PC
+#define _SP _M.SPR
+#define _IR _M.IR
+#define _W _M.W
+#define _Z _M.Z
+#define _ACT _M.ACT
+#define _TMP _M.TMP
+#define _ALU _M.ALU
+#define _Regs _M.Regs
+#define _LF_OP _M.LF_OP
+#define _LF_A _M.LF_A
+#define _LF_B _M.LF_B
+#define _LF_R _M.LF_R
+#define INTE _M.INTE
+#define _AB _M.AB
+#define _DB _M.DB
+#define MMU_BLOCK_SEL_REG _M.MMU_BLOCK_SEL_REG
+#define MMU_MAP _M.MMU_MAP
+#define MMU_BASE _M.MMU_BASE
+
+//CPU blocks with pinned lines mapped (MMU map change)
+void pin_map()
+{
+#if PIN_NUM
+  uint8_t i;
+  uint8_t block;
+  PIN_BLK = 0;
+  for (i = 0; i < PIN_NUM; i++) {
+    block = (PIN_TAG[i] % (65536UL / CACHE_LINE_SIZE)) / (MMU_BLOCK_SIZE / CACHE_LINE_SIZE);
+    if (MMU_MAP[block] == PIN_TAG[i] / (65536UL / CACHE_LINE_SIZE)) {
+      PIN_BLK |= (1 << block);
+    }
+  }
+#endif
+}
+
 //set bank for block
 void bank_set(uint8_t block, uint8_t bank)
 {
   MMU_MAP[block] = bank;
+  MMU_BASE[block] = (uint16_t)bank * (uint16_t)(65536UL / CACHE_LINE_SIZE);
+  FW_BASE = FW_NONE;//fetch window invalidation
+  pin_map();
 }
 //get bank for block
 uint8_t bank_get(uint8_t block)
@@ -52,166 +944,232 @@ uint8_t bank_get(uint8_t block)
   return MMU_MAP[block];
 }
 
+//physical line # (cache tag): block base (bank_set) + line # in 64K
+uint16_t _mem_tag(uint16_t adr) {
+  return MMU_BASE[adr / MMU_BLOCK_SIZE] + adr / CACHE_LINE_SIZE;
+}
+
+//cache hits (both sides)
+uint32_t cache_hits() {
+#if CACHE_SPLIT
+  return CACHE.hits + ICACHE.hits;
+#else
+  return CACHE.hits;
+#endif
+}
+
+//cache misses (both sides)
+uint32_t cache_misses() {
+#if CACHE_SPLIT
+  return CACHE.misses + ICACHE.misses;
+#else
+  return CACHE.misses;
+#endif
+}
+
+//line by physical line #: D-side (code - I-side) lookup, miss - line fill
+//returns line data, NULL - memory error
+uint8_t* _cache_line(uint16_t tag, bool code) {
+  uint8_t idx;
+#if CACHE_SPLIT
+  if (code) {
+    idx = ICACHE.find(tag);
+    if (idx == CACHE_ERR) {
+      return NULL;
+    }
+    cache_sel = idx ^ CACHE_PEER;//I-side line - flag set, D-side line - flag clear
+    if (idx & CACHE_PEER) {
+      return CACHE.ptr(idx & ~CACHE_PEER);
+    }
+    return ICACHE.ptr(idx);
+  }
+#else
+  (void)code;//one side only
+#endif
+  idx = CACHE.find(tag);
+  if (idx == CACHE_ERR) {
+    return NULL;
+  }
+  cache_sel = idx;
+#if CACHE_SPLIT
+  if (idx & CACHE_PEER) {
+    return ICACHE.ptr(idx & ~CACHE_PEER);
+  }
+#endif
+  return CACHE.ptr(idx);
+}
+
+//last accessed line written
+void sel_dirty() {
+  if (cache_sel == CACHE_ERR) {
+    return;//pinned line
+  }
+#if CACHE_SPLIT
+  if (cache_sel & CACHE_PEER) {
+    ICACHE.dirty(cache_sel & ~CACHE_PEER);
+    return;
+  }
+#endif
+  CACHE.dirty(cache_sel);
+}
+
+//line of address: pinned line or cache line (miss - line fill)
+//code - code fetch (CACHE_SPLIT - I-side)
+//returns line data, NULL - memory error
+uint8_t* _mem_line(uint16_t adr, bool code = false) {
+  uint16_t tag;
+  uint8_t* line;
+  tag = _mem_tag(adr);
+#if PIN_NUM
+  uint8_t i;
+  if (PIN_BLK & (1 << (adr / MMU_BLOCK_SIZE))) {
+    for (i = 0; i < PIN_NUM; i++) {
+      if (PIN_TAG[i] == tag) {
+        cache_sel = CACHE_ERR;
+        return PIN_DATA[i];
+      }
+    }
+  }
+#endif
+#if MEM_STAT
+  uint32_t misses;
+  misses = cache_misses();
+  line = _cache_line(tag, code);
+  if ((cache_misses() != misses) && (MST_BLK[adr / MMU_BLOCK_SIZE] != 0xFFFF)) {
+    MST_BLK[adr / MMU_BLOCK_SIZE]++;
+  }
+#else
+  line = _cache_line(tag, code);
+#endif
+  return line;
+}
+
+//line by physical line # (any bank, MMU map not used)
+//returns line data, NULL - memory error
+uint8_t* _phys_line(uint16_t tag) {
+#if PIN_NUM
+  uint8_t i;
+  for (i = 0; i < PIN_NUM; i++) {
+    if (PIN_TAG[i] == tag) {
+      cache_sel = CACHE_ERR;
+      return PIN_DATA[i];
+    }
+  }
+#endif
+  return _cache_line(tag, false);
+}
+
 //address <- _AB
 //data -> _DB
-
-void _RDMEM() {
-  uint32_t blk;
-  uint32_t blk_tmp;
-  uint16_t start_tmp;
-  uint16_t i;
-  uint8_t sel_blk;
-  uint8_t res;
-  uint8_t LRC;
+//code - code fetch (CACHE_SPLIT - I-side)
+void _RDMEM(bool code = false) {
+  uint8_t* line;
   if (_AB>MEM_MAX) {
     _DB = 0xFF;//not memory
     return;
   }
-        blk = ((uint32_t)(_AB) + (uint32_t)((MMU_MAP[_AB / MMU_BLOCK_SIZE]) * 65536UL)) / CACHE_LINE_SIZE; 
-        blk = blk +  SD_MEM_OFFSET;
-        //Serial.println(blk, HEX);
-        sel_blk = 0xff;
-        i=0;
-        do {
-          if (blk == cache_tag[i]) {
-            sel_blk = i;
-          }
-          i++;
-        } while ((sel_blk == 0xff) && (i<CACHE_LINES_NUM)) ;
-        if (sel_blk == 0xff) { //cache miss
-          sel_blk = CACHE_LINES_NUM-1;
-          if (cache_tag[sel_blk] != CACHE_LINE_EMPTY) 
-          {            
-            if (cache_tag[0] != CACHE_LINE_EMPTY) {
-            //line 0 -> SD
-              if (cache_dirty[0]) {
-                LRC = 0;//LRC reset
-                for(i=0;i<CACHE_LINE_SIZE;i++) {
-                  _buffer[i] = cache[cache_start[0]+i];
-                  LRC = _buffer[i] ^ LRC;//LRC calculation
-                }
-                _buffer[CACHE_LINE_SIZE] = LRC;//LRC write
-                res = writeSD(cache_tag[0]);
-              }
-            }
-            //move up
-            start_tmp = cache_start[0];
-            blk_tmp = cache_tag[0];
-            for(i=1;i<CACHE_LINES_NUM;i++) {
-              cache_start[i-1] = cache_start[i];
-              cache_tag[i-1] = cache_tag[i];
-            }
-            cache_start[CACHE_LINES_NUM-1] = start_tmp;
-            cache_tag[CACHE_LINES_NUM-1] = blk_tmp;
-          }
-          //read new line from SD
-          cache_tag[sel_blk] = blk;
-          res = readSD(blk, 0);
-          LRC = 0;//LRC reset
-          for(i=0;i<CACHE_LINE_SIZE;i++) {
-               cache[cache_start[sel_blk]+i] = _buffer[i];
-               LRC = _buffer[i] ^ LRC;//LRC calculation
-            }
-          if (_buffer[CACHE_LINE_SIZE] != LRC) {
-            MEM_ERR = true;
-            exitFlag = true;//quit to monitor
-            _DB = 0x00;
-            return;
-          }
-          cache_dirty[sel_blk] = false;
-        }
-        else { //cache hit
-          if (sel_blk != CACHE_LINES_NUM-1) {
-            //cache lines swap
-            start_tmp = cache_start[sel_blk+1];
-            cache_start[sel_blk+1] = cache_start[sel_blk];
-            cache_start[sel_blk] = start_tmp;
-            blk_tmp = cache_tag[sel_blk+1];
-            cache_tag[sel_blk+1] = cache_tag[sel_blk];
-            cache_tag[sel_blk] = blk_tmp;
-            sel_blk++;
-          }
-        }
-        _DB = cache[cache_start[sel_blk] + (_AB & (CACHE_LINE_SIZE - 1))];//read from cache
+  line = _mem_line(_AB, code);
+  if (line == NULL) {
+    _DB = 0x00;
+    return;
+  }
+  line_sel = line;
+  _DB = line[_AB & (CACHE_LINE_SIZE - 1)];//read from line
 }
 
 //address <- _AB
 //data <- _DB
 void _WRMEM() {
-  uint32_t blk;
-  uint32_t blk_tmp;
-  uint16_t start_tmp;
-  uint16_t i;
-  uint8_t sel_blk;
-  uint8_t res;
-  uint8_t LRC;
+  uint8_t* line;
   if (_AB>MEM_MAX) {
     return;
   }
-        blk = ((uint32_t)(_AB) + (uint32_t)((MMU_MAP[_AB / MMU_BLOCK_SIZE]) * 65536UL)) / CACHE_LINE_SIZE; 
-        blk = blk +  SD_MEM_OFFSET;
-        sel_blk = 0xff;
-        i=0;
-        do {
-          if (blk == cache_tag[i]) {
-            sel_blk = i;
-          }
-          i++;
-        } while ((sel_blk == 0xff) && (i<CACHE_LINES_NUM)) ;
-        if (sel_blk == 0xff) { //cache miss
-          sel_blk = CACHE_LINES_NUM-1;
-          if (cache_tag[sel_blk] != CACHE_LINE_EMPTY) 
-          {            
-            if (cache_tag[0] != CACHE_LINE_EMPTY) {
-            //line 0 -> SD
-              if (cache_dirty[0]) {
-                LRC = 0;//LRC reset
-                for(i=0;i<CACHE_LINE_SIZE;i++) {
-                  _buffer[i] = cache[cache_start[0]+i];
-                  LRC = _buffer[i] ^ LRC;//LRC calculation
-                }
-                _buffer[CACHE_LINE_SIZE] = LRC;//LRC add
-                res = writeSD(cache_tag[0]);
-              }
-            }
-            //move up
-            start_tmp = cache_start[0];
-            blk_tmp = cache_tag[0];
-            for(i=1;i<CACHE_LINES_NUM;i++) {
-              cache_start[i-1] = cache_start[i];
-              cache_tag[i-1] = cache_tag[i];
-            }
-            cache_start[CACHE_LINES_NUM-1] = start_tmp;
-            cache_tag[CACHE_LINES_NUM-1] = blk_tmp;
-          }
-          //read new line from SD
-          cache_tag[sel_blk] = blk;
-          res = readSD(blk, 0);
-          LRC = 0;//LRC reset
-          for(i=0;i<CACHE_LINE_SIZE;i++) {
-               cache[cache_start[sel_blk]+i] = _buffer[i];
-               LRC = _buffer[i] ^ LRC;//LRC calculation
-            }
-          if (_buffer[CACHE_LINE_SIZE] != LRC) {
-            MEM_ERR = true;
-            exitFlag = true;//quit to monitor
-            return;
-          }
-          cache_dirty[sel_blk] = false;
-        }        
-        else { //cache hit
-          if (sel_blk != CACHE_LINES_NUM-1) {
-            start_tmp = cache_start[sel_blk+1];
-            cache_start[sel_blk+1] = cache_start[sel_blk];
-            cache_start[sel_blk] = start_tmp;
-            blk_tmp = cache_tag[sel_blk+1];
-            cache_tag[sel_blk+1] = cache_tag[sel_blk];
-            cache_tag[sel_blk] = blk_tmp;
-            sel_blk++;
-          }
-        }
-        cache[cache_start[sel_blk] + (_AB & (CACHE_LINE_SIZE - 1))] = _DB;//cache update
-        cache_dirty[sel_blk] = true;
+  line = _mem_line(_AB);
+  if (line == NULL) {
+    return;
+  }
+  line_sel = line;
+  line[_AB & (CACHE_LINE_SIZE - 1)] = _DB;//line update
+  sel_dirty();
+  dbc_wr(_AB);//decoded code invalidation
+}
+
+//code read through fetch window
+//address <- _AB
+//data -> _DB
+void _RDCODE() {
+  if ((_AB & ~(CACHE_LINE_SIZE - 1)) == FW_BASE) {
+    _DB = FW_PTR[_AB & (CACHE_LINE_SIZE - 1)];
+  }
+  else {
+    _RDMEM(true);
+    if ((_AB <= MEM_MAX) && !MEM_ERR) {
+      FW_BASE = _AB & ~(CACHE_LINE_SIZE - 1);
+      FW_PTR = line_sel;
+    }
+  }
+}
+
+//16-bit read (low byte first)
+//both bytes in one line - one line lookup
+//address <- _AB
+uint16_t _RDMEM16() {
+  uint16_t adr;
+  uint8_t lo;
+  adr = _AB;
+  _RDMEM();
+  lo = _DB;
+  _AB = adr + 1;
+  if (((adr & (CACHE_LINE_SIZE - 1)) != (CACHE_LINE_SIZE - 1)) && (adr < MEM_MAX) && !MEM_ERR) {
+    _DB = line_sel[_AB & (CACHE_LINE_SIZE - 1)];
+  }
+  else {
+    _RDMEM();//line or bank border
+  }
+  return word(_DB, lo);
+}
+
+//16-bit write (low byte first)
+//both bytes in one line - one line lookup
+//address <- _AB
+void _WRMEM16(uint16_t dat) {
+  uint16_t adr;
+  adr = _AB;
+  _DB = lowByte(dat);
+  _WRMEM();
+  _AB = adr + 1;
+  _DB = highByte(dat);
+  if (((adr & (CACHE_LINE_SIZE - 1)) != (CACHE_LINE_SIZE - 1)) && (adr < MEM_MAX) && !MEM_ERR) {
+    line_sel[_AB & (CACHE_LINE_SIZE - 1)] = _DB;
+    dbc_wr(_AB);//decoded code invalidation
+  }
+  else {
+    _WRMEM();//line or bank border
+  }
+}
+
+//one dirty line (with its sector / adjacent run) written back, data cache first
+//returns true - line written back
+bool mem_flush_one() {
+#if CACHE_SPLIT
+  return CACHE.flush_one() || ICACHE.flush_one();
+#else
+  return CACHE.flush_one();
+#endif
+}
+
+//background write-back (console idle)
+//one dirty line per call, so evictions in the next burst are clean and cost only a read
+void mem_idle() {
+#if MEM_STAT
+  uint32_t t0;
+  t0 = micros();
+  if (mem_flush_one()) {
+    MST_SD_US += micros() - t0;
+  }
+#else
+  mem_flush_one();
+#endif
 }
 
 uint8_t _getMEM(uint16_t adr) {
@@ -226,6 +1184,206 @@ void _setMEM(uint16_t adr, uint8_t dat) {
   _WRMEM();
 }
 
+//memory statistics reset
+void mem_stat_reset() {
+#if MEM_STAT
+  uint8_t i;
+#endif
+  CACHE.stat_reset();
+#if CACHE_SPLIT
+  ICACHE.stat_reset();
+#endif
+#if VICTIM_NUM
+  VB_HITS = 0;
+#endif
+#if L2_SPIRAM
+  L2_HITS = 0;
+  L2_MISSES = 0;
+#endif
+#if MEM_STAT
+  MST_WB = 0;
+  MST_SD_RD = 0;
+  MST_SD_WR = 0;
+  MST_LRC = 0;
+  MST_SD_US = 0;
+  for (i = 0; i < MMU_BANKS_NUM; i++) {
+    MST_BANK[i] = 0;
+  }
+  for (i = 0; i < MMU_BLOCKS_NUM; i++) {
+    MST_BLK[i] = 0;
+  }
+#endif
+}
+
+#if MEM_STAT
+//32-bit counter by number
+uint32_t mst_cnt(uint8_t n) {
+  switch (n) {
+    case 0:
+      return cache_hits();
+    case 1:
+      return cache_misses();
+    case 2:
+      return MST_WB;
+    case 3:
+      return MST_SD_RD;
+    case 4:
+      return MST_SD_WR;
+    case 5:
+      return MST_LRC;
+  }
+  return MST_SD_US;
+}
+
+//next statistics record byte (port read)
+uint8_t mst_read() {
+  uint8_t dat;
+  uint8_t n;
+  if (MST_PTR >= MST_REC_SIZE) {
+    return 0x00;//record end
+  }
+  if (MST_PTR < (MST_CNT_NUM * 4)) {
+    if ((MST_PTR % 4) == 0) {
+      MST_LATCH = mst_cnt(MST_PTR / 4);
+    }
+    dat = uint8_t(MST_LATCH >> (8 * (MST_PTR % 4)));
+  }
+  else {
+    n = (MST_PTR - MST_CNT_NUM * 4) / 2;
+    if ((MST_PTR % 2) == 0) {
+      if (n < MMU_BANKS_NUM) {
+        MST_LATCH = MST_BANK[n];
+      }
+      else {
+        MST_LATCH = MST_BLK[n - MMU_BANKS_NUM];
+      }
+    }
+    dat = uint8_t(MST_LATCH >> (8 * (MST_PTR % 2)));
+  }
+  MST_PTR++;
+  if ((MST_PTR == MST_REC_SIZE) && MST_RESET) {
+    mem_stat_reset();
+  }
+  return dat;
+}
+#endif
+
+//hits, misses & hit rate
+void cache_rate(uint32_t hits, uint32_t misses) {
+  uint32_t total;
+  uint16_t rate;
+  Serial.print(F("HITS: "));
+  Serial.println(hits, DEC);
+  Serial.print(F("MISSES: "));
+  Serial.println(misses, DEC);
+  total = hits + misses;
+  while (total > 4000000UL) {
+    //overflow guard
+    hits = hits >> 1;
+    total = total >> 1;
+  }
+  if (total != 0) {
+    rate = hits * 1000UL / total;//0.1%
+    Serial.print(F("HIT RATE: "));
+    Serial.print(rate / 10, DEC);
+    Serial.print(F("."));
+    Serial.print(rate % 10, DEC);
+    Serial.println(F("%"));
+  }
+}
+
+//cache statistics
+void cache_stat() {
+  Serial.print(F("POLICY: "));
+  switch (CACHE.policy) {
+    case CACHE_FIFO:
+      Serial.println(F("FIFO"));
+      break;
+    case CACHE_CLOCK:
+      Serial.println(F("CLOCK"));
+      break;
+    case CACHE_2Q:
+      Serial.println(F("2Q"));
+      break;
+  }
+  cache_rate(cache_hits(), cache_misses());
+#if CACHE_SPLIT
+  Serial.println(F("I-SIDE"));
+  cache_rate(ICACHE.hits, ICACHE.misses);
+  Serial.println(F("D-SIDE"));
+  cache_rate(CACHE.hits, CACHE.misses);
+#endif
+  Serial.print(F("PREFETCH: "));
+  if (CACHE.prefetch) {
+    Serial.println(F("ON"));
+  }
+  else {
+    Serial.println(F("OFF"));
+  }
+#if CACHE_SPLIT
+  Serial.print(F("PREFETCHED: "));
+  Serial.println(CACHE.pf_issued + ICACHE.pf_issued, DEC);
+  Serial.print(F("USED: "));
+  Serial.println(CACHE.pf_used + ICACHE.pf_used, DEC);
+  Serial.print(F("WASTED: "));
+  Serial.println(CACHE.pf_wasted + ICACHE.pf_wasted, DEC);
+#else
+  Serial.print(F("PREFETCHED: "));
+  Serial.println(CACHE.pf_issued, DEC);
+  Serial.print(F("USED: "));
+  Serial.println(CACHE.pf_used, DEC);
+  Serial.print(F("WASTED: "));
+  Serial.println(CACHE.pf_wasted, DEC);
+#endif
+#if VICTIM_NUM
+  Serial.print(F("VICTIM HITS: "));
+  Serial.println(VB_HITS, DEC);
+#endif
+#if L2_SPIRAM
+  Serial.print(F("L2 HITS: "));
+  Serial.println(L2_HITS, DEC);
+  Serial.print(F("L2 MISSES: "));
+  Serial.println(L2_MISSES, DEC);
+#endif
+}
+
+#if MEM_STAT
+//memory statistics
+void mem_stat() {
+  uint8_t i;
+  Serial.print(F("HITS: "));
+  Serial.println(cache_hits(), DEC);
+  Serial.print(F("MISSES: "));
+  Serial.println(cache_misses(), DEC);
+  Serial.print(F("WRITE-BACKS: "));
+  Serial.println(MST_WB, DEC);
+  Serial.print(F("SD READS: "));
+  Serial.println(MST_SD_RD, DEC);
+  Serial.print(F("SD WRITES: "));
+  Serial.println(MST_SD_WR, DEC);
+  Serial.print(F("LRC ERRORS: "));
+  Serial.println(MST_LRC, DEC);
+  Serial.print(F("SD TIME, US: "));
+  Serial.println(MST_SD_US, DEC);
+  if ((MST_SD_RD + MST_SD_WR) != 0) {
+    Serial.print(F("SD TIME PER ACCESS, US: "));
+    Serial.println(MST_SD_US / (MST_SD_RD + MST_SD_WR), DEC);
+  }
+  Serial.print(F("MISSES PER BANK:"));
+  for (i = 0; i < MMU_BANKS_NUM; i++) {
+    Serial.print(' ');
+    Serial.print(MST_BANK[i], DEC);
+  }
+  Serial.println();
+  Serial.print(F("MISSES PER BLOCK:"));
+  for (i = 0; i < MMU_BLOCKS_NUM; i++) {
+    Serial.print(' ');
+    Serial.print(MST_BLK[i], DEC);
+  }
+  Serial.println();
+}
+#endif
+
 //MEMORY TEST
 uint32_t mem_test(boolean brk)
 {
@@ -240,7 +1398,7 @@ uint32_t mem_test(boolean brk)
     _DB = pgm_read_byte_near(memtest_table + j);
     _WRMEM();
     if ((i % 8192) == 0) {
-      Serial.print(".");
+      Serial.print(F("."));
     }
     j++;
     if (j == MEMTEST_TABLE_SIZE) {
@@ -255,7 +1413,7 @@ uint32_t mem_test(boolean brk)
   j = 0;
   for (i = 0; i <= 0xFFFF; i++) {
     if ((i % 8192) == 0) {
-      Serial.print(".");
+      Serial.print(F("."));
     }
     _AB = i;
     _RDMEM();
@@ -280,7 +1438,7 @@ uint32_t mem_test(boolean brk)
     _DB = uint8_t(~(pgm_read_byte_near(memtest_table + j)));
     _WRMEM();
     if ((i % 8192) == 0) {
-      Serial.print(".");
+      Serial.print(F("."));
     }
     j++;
     if (j == MEMTEST_TABLE_SIZE) {
@@ -295,7 +1453,7 @@ uint32_t mem_test(boolean brk)
   j = 0;
   for (i = 0; i <= 0xFFFF; i++) {
     if ((i % 8192) == 0) {
-      Serial.print(".");
+      Serial.print(F("."));
     }
     _AB = i;
     _RDMEM();
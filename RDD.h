@@ -0,0 +1,92 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//RAM disk drive (M:)
+//sectors in MMU banks RD_BANK..MMU_BANKS_NUM-1 (not for programs bank switching),
+//FDD controller commands with drive M: selected - sector copy by memory DMA,
+//line by line, no SD-card sector round trip
+//directory is formatted once after power-up (memory generation stamp - empty banks)
+//1 - on
+//0 - off
+#define RAM_DISK 1
+
+#if RAM_DISK
+const uint8_t RD_DRV = 12;//drive number (M:)
+const uint8_t RD_BANK = 1;//first bank
+const uint16_t RD_SPT = 64;//sectors per track (8K)
+const uint8_t RD_TRACKS = (MMU_BANKS_NUM - RD_BANK) * (65536UL / SECTOR_SIZE) / RD_SPT;//tracks number
+const uint16_t RD_BLS = 2048;//allocation block size
+const uint16_t RD_DSM = (MMU_BANKS_NUM - RD_BANK) * (65536UL / RD_BLS) - 1;//disk size - 1 (blocks, < 256)
+const uint16_t RD_DRM = 127;//directory entries - 1
+const uint16_t RD_DIR_SIZE = (RD_DRM + 1) * 32;//directory size (bytes)
+
+//BIOS data (above BIOS traps)
+const uint16_t _RD_DPH = _ENDTRAP;//disk parameter header
+const uint16_t _RD_DPB = _RD_DPH + 16;//disk parameter block
+const uint16_t _RD_ALV = _RD_DPB + 16;//allocation vector (DSM / 8 + 1 bytes)
+
+boolean RD_FORMAT = false;//directory formatted
+
+//DPH & DPB (IPL)
+void rd_init() {
+  uint8_t i;
+  uint8_t reg[DMA_REGS_NUM];
+  //DPH: no translation, scratch, DIRBUF, DPB, no CSV, ALV
+  for (i = 0; i < 8; i++) {
+    _setMEM(_RD_DPH + i, 0x00);
+  }
+  _AB = _RD_DPH + 8;
+  _WRMEM16(_DIRBUF);
+  _AB = _RD_DPH + 10;
+  _WRMEM16(_RD_DPB);
+  _AB = _RD_DPH + 12;
+  _WRMEM16(0x0000);
+  _AB = _RD_DPH + 14;
+  _WRMEM16(_RD_ALV);
+  //DPB
+  _AB = _RD_DPB;
+  _WRMEM16(RD_SPT);//SPT
+  _setMEM(_RD_DPB + 2, 4);//BSH (2048)
+  _setMEM(_RD_DPB + 3, 15);//BLM
+  _setMEM(_RD_DPB + 4, 1);//EXM (DSM < 256)
+  _AB = _RD_DPB + 5;
+  _WRMEM16(RD_DSM);//DSM
+  _AB = _RD_DPB + 7;
+  _WRMEM16(RD_DRM);//DRM
+  _setMEM(_RD_DPB + 9, 0xC0);//AL0 (2 directory blocks)
+  _setMEM(_RD_DPB + 0xA, 0x00);//AL1
+  _AB = _RD_DPB + 0xB;
+  _WRMEM16(0x0000);//CKS (not removable)
+  _AB = _RD_DPB + 0xD;
+  _WRMEM16(0x0000);//OFF
+  //directory format
+  if (!RD_FORMAT) {
+    dma_regs(reg, RD_BANK, 0, RD_BANK, 0, RD_DIR_SIZE);
+    reg[DMA_VAL] = CPM_EMPTY;
+    RD_FORMAT = (dma_run(reg, DMA_FILL_CMD) == DMA_OK);
+  }
+}
+
+//sector read/write (FDD registers)
+//returns true - O.K., false - error
+boolean rd_io(uint8_t cmd) {
+  uint8_t reg[DMA_REGS_NUM];
+  uint32_t ofs;
+  uint8_t bank;
+  if ((FDD_REG_SEC < 1) || (FDD_REG_SEC > RD_SPT) || (FDD_REG_TRK >= RD_TRACKS)) {
+    return false;
+  }
+  ofs = ((uint32_t)FDD_REG_TRK * RD_SPT + FDD_REG_SEC - 1) * SECTOR_SIZE;
+  bank = RD_BANK + ofs / 65536UL;
+  if (cmd == FDD_RD_CMD) {
+    dma_regs(reg, bank, ofs, DMA_CPU, FDD_REG_DMA, SECTOR_SIZE);
+  }
+  else {
+    dma_regs(reg, DMA_CPU, FDD_REG_DMA, bank, ofs, SECTOR_SIZE);
+  }
+  return (dma_run(reg, DMA_MOVE_CMD) == DMA_OK);
+}
+#endif
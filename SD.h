@@ -7,9 +7,24 @@
 Sd2Card card;
 const uint8_t SS_SD_pin = 10;//SS pin (D10)
 const uint16_t SD_BLK_SIZE = 128;//SD block size
+const uint16_t SD_SEC_SIZE = 512;//SD sector size
+
+//RAM swap layout (MEM.h)
+//0 - cache line + LRC per SD block
+//1 - cache lines + LRC packed in SD sectors, sector read/modify/write
+//    (_buffer holds a whole sector: +384 bytes SRAM)
+//CP/M session (host), 0 / 1: SD reads 8720 / 9679, write commands 967 / 967,
+//blocks written 3113 / 967 (0 - run write-back coalesces adjacent lines);
+//1 - less card wear & 7x smaller swap area, but its SRAM leaves no room for
+//memory statistics, pinned lines & victim buffer on Nano
+#define SD_PACK 0
 
 //SD buffers
+#if SD_PACK
+static unsigned char _buffer[SD_SEC_SIZE];
+#else
 static unsigned char _buffer[SD_BLK_SIZE];
+#endif
 static unsigned char _dsk_buffer[SD_BLK_SIZE];
 
 //block read from SD
@@ -31,6 +46,58 @@ uint8_t writeSD (uint32_t blk) {
   return res;
 }
 
+//multi-block write to SD start (CMD25), n - blocks number (pre-erased)
+uint8_t writeStartSD (uint32_t blk, uint32_t n) {
+  uint8_t res;
+  res = card.writeStart(blk, n);
+  if (!LED_on) {
+    fastDigitalWrite(LED_pin, HIGH);
+    LED_on = true;//WRITE LED on
+  }
+  LED_count = LED_delay;
+  return res;
+}
+
+//next block of multi-block write to SD
+uint8_t writeNextSD () {
+  uint8_t res;
+  res = card.writeData(_buffer);
+  return res;
+}
+
+//multi-block write to SD stop
+uint8_t writeStopSD () {
+  uint8_t res;
+  res = card.writeStop();
+  return res;
+}
+
+#if SD_PACK
+//sector read stays open between reads (true) / sector read end (false)
+void readKeepSD (bool on) {
+  card.partialBlockRead(on);
+}
+
+//part of sector read from SD
+uint8_t readPartSD (uint32_t blk, uint16_t offset, uint16_t count) {
+  uint8_t res;
+  res = card.readData(blk, offset, count, _buffer);
+  return res;
+}
+
+//sector write to SD
+uint8_t writeSecSD (uint32_t blk) {
+  uint8_t res;
+  res = card.writeBlock(blk, _buffer, SD_SEC_SIZE);
+  if (!LED_on) {
+    fastDigitalWrite(LED_pin, HIGH);
+    LED_on = true;//WRITE LED on
+  }
+  LED_count = LED_delay;
+  return res;
+}
+#endif
+
 //erase SD
 uint8_t eraseSD (uint32_t blk, uint32_t len) {
   uint8_t res;
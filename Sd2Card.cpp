@@ -499,14 +499,16 @@ uint8_t Sd2Card::waitStartBlock(void) {
 }
 //------------------------------------------------------------------------------
 /**
- * Writes a 128 byte block to an SD card.
+ * Writes a block to an SD card, sector tail is padded with zeros.
  *
  * \param[in] blockNumber Logical block to be written.
  * \param[in] src Pointer to the location of the data to be written.
+ * \param[in] count Number of bytes to write (128 by default, up to 512).
  * \return The value one, true, is returned for success and
  * the value zero, false, is returned for failure.
  */
-uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src) {
+uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src,
+          uint16_t count) {
 #if SD_PROTECT_BLOCK_ZERO
   // don't allow write to first block
   if (blockNumber == 0) {
@@ -521,7 +523,7 @@ uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src) {
     error(SD_CARD_ERROR_CMD24);
     goto fail;
   }
-  if (!writeData(DATA_START_BLOCK, src)) goto fail;
+  if (!writeData(DATA_START_BLOCK, src, count)) goto fail;
 
   // wait for flash programming to complete
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
@@ -549,11 +551,11 @@ uint8_t Sd2Card::writeData(const uint8_t* src) {
     chipSelectHigh();
     return false;
   }
-  return writeData(WRITE_MULTIPLE_TOKEN, src);
+  return writeData(WRITE_MULTIPLE_TOKEN, src, 128);
 }
 //------------------------------------------------------------------------------
 // send one block of data for write block or write multiple blocks
-uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
+uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src, uint16_t count) {
 #ifdef OPTIMIZE_HARDWARE_SPI
 
   // send data - optimized loop
@@ -562,10 +564,10 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
   // send two byte per iteration
   for (uint16_t i = 0; i < 512; i += 2) {
     while (!(SPSR & (1 << SPIF)));
-    if (i<128) { SPDR = src[i]; }
+    if (i < count) { SPDR = src[i]; }
     else { SPDR = 0; }
     while (!(SPSR & (1 << SPIF)));
-    if (i<127) { SPDR = src[i+1]; }
+    if ((i + 1) < count) { SPDR = src[i+1]; }
     else { SPDR = 0; }
   }
 
@@ -575,7 +577,7 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
 #else  // OPTIMIZE_HARDWARE_SPI
   spiSend(token);
   for (uint16_t i = 0; i < 512; i++) {
-    if (i<128) { spiSend(src[i]); }
+    if (i < count) { spiSend(src[i]); }
     else {
       spiSend(0);
     }
@@ -593,6 +595,45 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t* src) {
   return true;
 }
 
+//------------------------------------------------------------------------------
+/** Start a write multiple blocks sequence.
+ *
+ * \param[in] blockNumber Address of first block in sequence.
+ * \param[in] eraseCount The number of blocks to be pre-erased.
+ *
+ * \note This function is used with writeData() and writeStop()
+ * for optimized multiple block writes.
+ *
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
+#if SD_PROTECT_BLOCK_ZERO
+  // don't allow write to first block
+  if (blockNumber == 0) {
+    error(SD_CARD_ERROR_WRITE_BLOCK_ZERO);
+    goto fail;
+  }
+#endif  // SD_PROTECT_BLOCK_ZERO
+  // send pre-erase count
+  if (cardAcmd(ACMD23, eraseCount)) {
+    error(SD_CARD_ERROR_ACMD23);
+    goto fail;
+  }
+  // use address if not SDHC card
+  if (type() != SD_CARD_TYPE_SDHC) blockNumber <<= 9;
+  if (cardCommand(CMD25, blockNumber)) {
+    error(SD_CARD_ERROR_CMD25);
+    goto fail;
+  }
+  return true;
+
+ fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
+/** End a write multiple blocks sequence. */
 uint8_t Sd2Card::writeStop(void) {
   if (!waitNotBusy(SD_WRITE_TIMEOUT)) goto fail;
   spiSend(STOP_TRAN_TOKEN);
@@ -201,9 +201,10 @@ class Sd2Card {
   uint8_t setSckRate(uint8_t sckRateID);
   /** Return the card type: SD V1, SD V2 or SDHC */
   uint8_t type(void) const {return type_;}
-  uint8_t writeBlock(uint32_t blockNumber, const uint8_t* src);
+  uint8_t writeBlock(uint32_t blockNumber, const uint8_t* src,
+          uint16_t count = 128);
   uint8_t writeData(const uint8_t* src);
-  //uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
+  uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
   uint8_t writeStop(void);
  private:
   uint32_t block_;
@@ -227,7 +228,7 @@ class Sd2Card {
   void chipSelectLow(void);
   void type(uint8_t value) {type_ = value;}
   uint8_t waitNotBusy(uint16_t timeoutMillis);
-  uint8_t writeData(uint8_t token, const uint8_t* src);
+  uint8_t writeData(uint8_t token, const uint8_t* src, uint16_t count);
   uint8_t waitStartBlock(void);
 };
 #endif  // Sd2Card_h
@@ -46,6 +46,8 @@ SpiRAM::SpiRAM(byte clockDiv, byte ssPin)
 {
   SPI.begin();
   // Ensure the RAM chip is disabled in the first instance
+  _ssPin = ssPin;
+  pinMode(_ssPin, OUTPUT);
   disable();
 
   // Set the spi mode using the requested clock speed
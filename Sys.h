@@ -4,16 +4,60 @@
 *   Website:  https://acdc.foxylab.com
 */
 
-volatile uint8_t _DB; //data bus buffer
-volatile uint16_t _AB; //data bus buffer
-
-volatile bool exitFlag = false;
+//attention word - execution loop leaves the fast path if not 0
+const uint8_t ATN_EXIT = B00000001;//exit to monitor (HLT, CTRL-\, memory error, BIOS error)
+const uint8_t ATN_DEBUG = B00000010;//debug mode - single step
+const uint8_t ATN_BREAK = B00000100;//breakpoint armed
+volatile uint8_t ATN = 0;
 
 const uint8_t MEM_SIZE = 64;//System RAM Size, KBytes
 const uint16_t MEM_MAX = (MEM_SIZE-1)*1024U + 1023U;//maximum system RAM address
 uint32_t RAM_AVAIL = 0x10000L;//available RAM Size, KBytes (64 KBytes maximum)
 const uint8_t RAM_SIZE = 64;//RAM Size for CP/M, KBytes
 
+//SRAM (AVR)
+//static - .data + .bss, free - between heap end and stack,
+//painted at start, bytes never touched by the stack since then - stack low-water mark
+//SP - stack pointer register, RAMSTART - <avr/io.h>
+const uint8_t STACK_PAINT = 0xA5;//paint byte
+extern char __heap_start;//linker script - end of .data + .bss
+extern char* __brkval;//avr-libc malloc - heap end (0 - no heap)
+
+//free SRAM start
+uint8_t* sram_free_start() {
+  if (__brkval == 0) {
+    return (uint8_t*)&__heap_start;
+  }
+  return (uint8_t*)__brkval;
+}
+
+//free SRAM painting
+void stack_paint() {
+  uint8_t* p;
+  p = sram_free_start();
+  while (p < (uint8_t*)(SP - 16)) {
+    *p = STACK_PAINT;
+    p++;
+  }
+}
+
+//static SRAM size (bytes)
+uint16_t sram_static() {
+  return (uint16_t)(uintptr_t)&__heap_start - RAMSTART;
+}
+
+//stack low-water mark - free SRAM bytes never used (bytes)
+uint16_t stack_free() {
+  uint8_t* p;
+  uint16_t n;
+  n = 0;
+  p = sram_free_start();
+  while ((p < (uint8_t*)SP) && (*p == STACK_PAINT)) {
+    p++;
+    n++;
+  }
+  return n;
+}
 
 //AUX
 boolean LED_on = false;
@@ -32,6 +32,7 @@
 
 #include <avr/pgmspace.h>
 #include "Sd2Card.h"
+#include "SpiRAM.h"
 #include "PS2Keyboard.h"
 #include "EEPROM.h"
 //#include "Wire.h"
@@ -52,8 +53,16 @@ const char VER_MINOR = '3';
 
 #include "MEM.h"
 
+#include "DBC.h"
+
+#include "CLK.h"
+
 #include "FDD.h"
 
+#include "DMA.h"
+
+#include "RDD.h"
+
 #include "CONIO.h"
 
 #include "IO.h"
@@ -71,11 +80,14 @@ EEPROM cells
                0x02 - drive C
                0x03 - drive D
                0x04 - sense sw
+               0x05 - SD RAM area generation, low byte
+               0x06 - SD RAM area generation, high byte
 */
 //EEPROM init
 const int EEPROM_SIZE = 256;
 const int EEPROM_DRIVES = 0x00;
 const int EEPROM_SENSE_SW = EEPROM_DRIVES+FDD_NUM;
+const int EEPROM_SWAP_GEN = EEPROM_SENSE_SW+1;//2 bytes
 int EEPROM_idx;
 void EEPROM_init() {
   //EEPROM clearing
@@ -99,50 +111,140 @@ void EEPROM_init() {
 
 #include "i8080_fns.h"
 
+//execution core
+//0 - fetch/decode loop, indirect call through doCmdArray
+//1 - threaded code, every handler jumps to the next one (computed goto),
+//    faster but the dispatch is copied into all 256 handlers (flash size)
+//monitor P command - instructions per second of the built core
+//(host build of the same sources: 0 - 114M/s, 1 - 138M/s)
+#define CORE_THREADED 0
+
+//fast path - one attention word test per ATN_BATCH instructions (fetch/decode loop only)
+//slow path - exit, breakpoint compare and single step
+//exit latency with ATN_BATCH > 1 (test/atn.cpp):
+//breakpoint, single step - exact, armed bits keep the fast path off;
+//HLT - exact, HLT keeps PC, so the rest of the batch repeats it (cycles counted);
+//CTRL-\, memory & BIOS error - up to ATN_BATCH - 1 more instructions
+#define ATN_BATCH 1
+
+#if CORE_THREADED
+//threaded code dispatch
+#define _THREAD_NEXT() \
+    _AB = _PC; \
+    if (ATN) { goto CALL_SLOW; } \
+    _FETCH_OP(); \
+    goto *(void*) pgm_read_word (&doLblArray [_IR]);
+#define _THREAD_OP(n) op_##n: do##n(); _CLK_STEP(n); _THREAD_NEXT();
+#define _THREAD_ROW(h) \
+    _THREAD_OP(0x##h##0) _THREAD_OP(0x##h##1) _THREAD_OP(0x##h##2) _THREAD_OP(0x##h##3) \
+    _THREAD_OP(0x##h##4) _THREAD_OP(0x##h##5) _THREAD_OP(0x##h##6) _THREAD_OP(0x##h##7) \
+    _THREAD_OP(0x##h##8) _THREAD_OP(0x##h##9) _THREAD_OP(0x##h##A) _THREAD_OP(0x##h##B) \
+    _THREAD_OP(0x##h##C) _THREAD_OP(0x##h##D) _THREAD_OP(0x##h##E) _THREAD_OP(0x##h##F)
+#define _THREAD_LBL(h) \
+    &&op_0x##h##0, &&op_0x##h##1, &&op_0x##h##2, &&op_0x##h##3, \
+    &&op_0x##h##4, &&op_0x##h##5, &&op_0x##h##6, &&op_0x##h##7, \
+    &&op_0x##h##8, &&op_0x##h##9, &&op_0x##h##A, &&op_0x##h##B, \
+    &&op_0x##h##C, &&op_0x##h##D, &&op_0x##h##E, &&op_0x##h##F,
+
 void call(word addr)
 {
-  byte cmd;
-  bool exe_flag;
-  exitFlag = false;
+  static const void* const doLblArray [] PROGMEM = {
+    _THREAD_LBL(0) _THREAD_LBL(1) _THREAD_LBL(2) _THREAD_LBL(3)
+    _THREAD_LBL(4) _THREAD_LBL(5) _THREAD_LBL(6) _THREAD_LBL(7)
+    _THREAD_LBL(8) _THREAD_LBL(9) _THREAD_LBL(A) _THREAD_LBL(B)
+    _THREAD_LBL(C) _THREAD_LBL(D) _THREAD_LBL(E) _THREAD_LBL(F)
+  };
+  ATN &= ~ATN_EXIT;
+  atn_sync();
+  _FETCH_START();
+  clk_start();
+  _PC = addr;
+  _THREAD_NEXT();
+  //handlers
+  _THREAD_ROW(0) _THREAD_ROW(1) _THREAD_ROW(2) _THREAD_ROW(3)
+  _THREAD_ROW(4) _THREAD_ROW(5) _THREAD_ROW(6) _THREAD_ROW(7)
+  _THREAD_ROW(8) _THREAD_ROW(9) _THREAD_ROW(A) _THREAD_ROW(B)
+  _THREAD_ROW(C) _THREAD_ROW(D) _THREAD_ROW(E) _THREAD_ROW(F)
+CALL_SLOW:
+  //slow path
+  if ((ATN & ATN_BREAK) && (_AB == breakpoint)) {
+    DEBUG = true;
+    atn_sync();
+  }
+  if (ATN & ATN_EXIT) { goto CALL_END; } //go to monitor
+  _FETCH_OP();//(AB) -> INSTR  instruction fetch
+  #include "debug.h" 
+  goto *(void*) pgm_read_word (&doLblArray [_IR]); //decode
+CALL_END:
+  if (MEM_ERR) {
+    MEM_ERR = false;
+    clrscr();
+    Serial.println();
+    Serial.println(F("MEMORY ERROR!"));
+  }
+}
+#else
+void call(word addr)
+{
+  #if ATN_BATCH > 1
+  uint8_t n;
+  #endif
+  ATN &= ~ATN_EXIT;
+  atn_sync();
+  _FETCH_START();
+  clk_start();
   _PC = addr;
   do
   {
+    //fast path
+    while (ATN == 0) {
+      #if ATN_BATCH > 1
+      for (n = 0; n < ATN_BATCH; n++) {
+      #endif
+      _AB = _PC;
+      _FETCH_OP();//(AB) -> INSTR  instruction fetch
+      (_DECODE()) (); //decode
+      _CLK_STEP(_IR);
+      #if ATN_BATCH > 1
+      }
+      #endif
+    }
+    //slow path
     _AB = _PC;
-    if (_AB ==  breakpoint) {
+    if ((ATN & ATN_BREAK) && (_AB == breakpoint)) {
       DEBUG = true;
+      atn_sync();
     }
-    if (exitFlag) { break; } //go to monitor
-    #include "BIOS_int.h"
-    _RDMEM();//(AB) -> INSTR  instruction fetch
-    _IR = _DB;
+    if (ATN & ATN_EXIT) { break; } //go to monitor
+    _FETCH_OP();//(AB) -> INSTR  instruction fetch
     #include "debug.h" 
-    ((CmdFunction) pgm_read_word (&doCmdArray [_IR])) (); //decode
+    (_DECODE()) (); //decode
+    _CLK_STEP(_IR);
   } while (true);
   if (MEM_ERR) {
     MEM_ERR = false;
     clrscr();
-    Serial.println("");
+    Serial.println();
     Serial.println(F("MEMORY ERROR!"));
   }
 }
+#endif
+
+#include "BENCH.h"
 
 //reset function
 void(* sys_reset) (void) = 0;
 
 void setup() {
   uint32_t i;
-  uint16_t j;
   uint8_t k;
   uint32_t _cardsize;
-  uint8_t res;
   bool RAMTestPass = true;
-  uint8_t LRC;
-  uint32_t blk;
-  uint32_t blk_end;
   uint32_t start_time;
   uint8_t bank;
   uint8_t block;
   uint8_t CHECKED_BANKS;
+  stack_paint();//stack low-water mark
   // start serial port at 9600 bps
   Serial.begin(9600);
   while (!Serial) {
@@ -172,19 +274,19 @@ void setup() {
   Serial.println(F("***************************************"));
   Serial.print(F("*     CP/M for Arduino Nano V")); 
   Serial.print(VER_MAJOR);
-  Serial.print(".");
+  Serial.print(F("."));
   Serial.print(VER_MINOR);
   Serial.println(F("      *"));
   Serial.println(F("* (C) 2017 Alexey V.Voronin @ FoxyLab *"));
   Serial.println(F("*      https://acdc.foxylab.com       *"));
   Serial.println(F("***************************************"));
-  Serial.println("");
+  Serial.println();
 /*
 asm (
   "1:         \n"
   "nop        \n" //repeating code goes here
   );
-  Serial.print("T");
+  Serial.print(F("T"));
   delay(100);
 asm (
   "jmp 1b        \n"
@@ -207,19 +309,11 @@ asm (
   con_flush();
   //MMU init
   for (i = 0; i < MMU_BLOCKS_NUM; i++) {
-    MMU_MAP[i] = 0;
+    bank_set(i, 0);
   }
   MMU_BLOCK_SEL_REG = 0;
   //cache init
-  for (i = 0; i < CACHE_LINES_NUM; i++) {
-    cache_tag[i] = 0xFFFFFFFF;
-  }
-  for (i = 0; i < CACHE_LINES_NUM; i++) {
-    cache_dirty[i] = true;
-  }
-  for (i = 0; i < CACHE_LINES_NUM; i++) {
-    cache_start[i] = i * CACHE_LINE_SIZE;
-  }
+  cache_init();
   //SD card init
   Serial.print(F("SD CARD INIT..."));
   do {
@@ -236,35 +330,21 @@ asm (
     }
   } while (_cardsize == 0);
 
-  //SD RAM AREA CLEARING
-  Serial.print(F("SD RAM AREA ERASING..."));
-  if (eraseSD(SD_MEM_OFFSET,65536UL/CACHE_LINE_SIZE*MMU_BANKS_NUM) == false) {
-    Serial.println(F("ERROR!"));
+  //SD RAM AREA GENERATION
+  //lines of previous generations read as zeros - no erase & init pass
+  //generation - SD swap area header, EEPROM copy
+  SWAP_GEN = swap_gen_next(word(EEPROM.read(EEPROM_SWAP_GEN + 1), EEPROM.read(EEPROM_SWAP_GEN)));
+  if (SWAP_GEN == 0) {
+    Serial.println(F("SD RAM AREA ERROR!"));
     while(1);
   }
-  else
-  {
-    Serial.println(F("O.K."));
-  }
-  Serial.print(F("SD RAM AREA INIT"));
-  blk = SD_MEM_OFFSET;
-  blk_end = blk + (65536UL/CACHE_LINE_SIZE) * MMU_BANKS_NUM;
-  i = 0;
-  do {
-    LRC = 0;//LRC reset
-    for(j=0;j<CACHE_LINE_SIZE;j++) {
-      _buffer[j] = 0;
-      LRC = 0 ^ LRC;//LRC calculation
-    }
-    _buffer[CACHE_LINE_SIZE] = LRC;//LRC add
-    res = writeSD(blk);
-    blk++;
-    if ((i % ((65536UL/CACHE_LINE_SIZE))) == 0) {
-      Serial.print(".");
-    }
-    i++;
-  } while (blk < blk_end);
-  Serial.println(F("O.K."));
+  EEPROM.write(EEPROM_SWAP_GEN, lowByte(SWAP_GEN));
+  EEPROM.write(EEPROM_SWAP_GEN + 1, highByte(SWAP_GEN));
+  Serial.print(F("SD RAM AREA GENERATION: "));
+  Serial.println(SWAP_GEN, DEC);
+#if L2_SPIRAM
+  l2_init();//L2 empty
+#endif
   Serial.println(F("SELECT BANK(S) FOR TEST: "));
   Serial.println(F("[0] - BANK 0, [1] - ALL BANKS"));
   RAM_TEST_MODE = 0xFF;
@@ -338,21 +418,21 @@ asm (
     }
     RAM_AVAIL = mem_test(false);
     Serial.print(RAM_AVAIL/1024, DEC);
-    Serial.print("K");
+    Serial.print(F("K"));
     if (RAM_AVAIL != 0x10000) {
-      Serial.println("");
-      Serial.println("RAM CHECK ERROR!");
+      Serial.println();
+      Serial.println(F("RAM CHECK ERROR!"));
       delay(3000);
       sys_reset();
     }
-    Serial.println("");
+    Serial.println();
   }
   //BANK 0 ACTIVE
   for (block=0;block<MMU_BLOCKS_NUM;block++) {
       bank_set(block,0);
   }
   Serial.print(RAM_AVAIL, DEC);
-  Serial.print(" X ");
+  Serial.print(F(" X "));
   Serial.print(MMU_BANKS_NUM, DEC);
   Serial.println(F(" BYTE(S) OF RAM ARE AVAILABLE"));
   color(9);
@@ -397,7 +477,7 @@ void loop() {
             mon_ptr--;
             mon_buffer[mon_ptr] = '\0';
             Serial.write(inChar);
-            Serial.write(" ");
+            Serial.write(' ');
             Serial.write(inChar);
           }
         }
@@ -419,4 +499,4 @@ void loop() {
 
 
 
-
+
@@ -22,7 +22,7 @@
   } while ((inChar != ' ') && (inChar != CTRL_C_KEY));
   loadcur();
   if (inChar == CTRL_C_KEY) {
-    exitFlag = true;
+    ATN |= ATN_EXIT;
   }
   }
 
@@ -12,15 +12,7 @@ extern void _setMEM(uint16_t adr, uint8_t dat);
 extern boolean con_ready();
 extern char con_read();
 
-//registers
-volatile uint8_t _W;// W register
-volatile uint8_t _Z;// Z register
-volatile uint8_t _ACT;// ACT register
-volatile uint8_t _TMP;// TMP register
-volatile uint8_t _ALU;// ALU
-volatile uint16_t _PC; //program counter
-volatile uint16_t _SP; //stack pointer
-volatile uint8_t _IR; //instruction register
+//registers - machine_t (MEM.h)
 
 #define _Reg_B B000
 #define _Reg_C B001
@@ -37,7 +29,7 @@ volatile uint8_t _IR; //instruction register
 #define _RP_SP B11
 #define _RP_AF B11
 
-uint8_t _Regs[8];
+//_Regs - machine_t (MEM.h)
 /*
   0 - B
   1 - C
@@ -66,21 +58,46 @@ uint8_t _Regs[8];
 #define _rpWZ word(_rW, _rZ);
 
 
-uint8_t SZP_RESET = B00111011;
 uint8_t ZP_RESET = B10111011;
-#define _setFlags_S(b) _Regs[_Reg_M] = (b==1) ? (_Regs[_Reg_M] | B10000000) : (_Regs[_Reg_M] & B01111111)
-#define _setFlags_Z(b) _Regs[_Reg_M] = (b==1) ? (_Regs[_Reg_M] | B01000000) : (_Regs[_Reg_M] & B10111111)
-#define _setFlags_A(b) _Regs[_Reg_M] = (b==1) ? (_Regs[_Reg_M] | B00010000) : (_Regs[_Reg_M] & B11101111)
-#define _setFlags_P(b) _Regs[_Reg_M] = (b==1) ? (_Regs[_Reg_M] | B00000100) : (_Regs[_Reg_M] & B11111011)
-#define _setFlags_C(b) _Regs[_Reg_M] = (b==1) ? (_Regs[_Reg_M] | B00000001) : (_Regs[_Reg_M] & B11111110)
-
-#define _getFlags_S()  (((_Regs[_Reg_M] & B10000000) != 0) ? (uint8_t(1)) : (uint8_t(0)))
-#define _getFlags_Z()  (((_Regs[_Reg_M] & B01000000) != 0) ? (uint8_t(1)) : (uint8_t(0)))
-#define _getFlags_A()  (((_Regs[_Reg_M] & B00010000) != 0) ? (uint8_t(1)) : (uint8_t(0)))
-#define _getFlags_P()  (((_Regs[_Reg_M] & B00000100) != 0) ? (uint8_t(1)) : (uint8_t(0)))
-#define _getFlags_C()  (((_Regs[_Reg_M] & B00000001) != 0) ? (uint8_t(1)) : (uint8_t(0)))
-
-#define _FLAGS(b) _rF = (_rF & SZP_RESET) | pgm_read_byte_near(SZP_table + b);
+//flags evaluation
+//0 - eager, every ALU operation computes S, Z, A, P, C at once
+//1 - lazy, ALU operation saves kind, operands and result only,
+//    F is computed when something reads it (Jccc, Cccc, Rccc, PUSH PSW, DAA, state)
+#define LAZY_FLAGS 1
+
+//ALU operation kinds for flags evaluation
+#define LF_NONE B000 //F is valid
+#define LF_ADD B001 //ADD, ADC, ADI, ACI
+#define LF_SUB B010 //SUB, SBB, SUI, SBI
+#define LF_CMP B011 //CMP, CPI
+#define LF_ANA B100 //ANA, ANI
+#define LF_ORA B101 //ORA, ORI, XRA, XRI
+#define LF_INR B110 //INR
+#define LF_DCR B111 //DCR
+
+//_LF_OP, _LF_A, _LF_B, _LF_R - machine_t (MEM.h)
+
+#if LAZY_FLAGS
+#define _rFv _flags_sync()
+#define _ALU_FLAGS(k, a, b, r) _LF_OP = k; _LF_A = a; _LF_B = b; _LF_R = r;
+#define _rF_SET(d) _rF = d; _LF_OP = LF_NONE;
+#else
+#define _rFv _Regs[_Reg_M]
+#define _ALU_FLAGS(k, a, b, r) _rF = _flags_eval(k, a, b, r);
+#define _rF_SET(d) _rF = d;
+#endif
+
+#define _setFlags_S(b) _Regs[_Reg_M] = (b==1) ? (_rFv | B10000000) : (_rFv & B01111111)
+#define _setFlags_Z(b) _Regs[_Reg_M] = (b==1) ? (_rFv | B01000000) : (_rFv & B10111111)
+#define _setFlags_A(b) _Regs[_Reg_M] = (b==1) ? (_rFv | B00010000) : (_rFv & B11101111)
+#define _setFlags_P(b) _Regs[_Reg_M] = (b==1) ? (_rFv | B00000100) : (_rFv & B11111011)
+#define _setFlags_C(b) _Regs[_Reg_M] = (b==1) ? (_rFv | B00000001) : (_rFv & B11111110)
+
+#define _getFlags_S()  (((_rFv & B10000000) != 0) ? (uint8_t(1)) : (uint8_t(0)))
+#define _getFlags_Z()  (((_rFv & B01000000) != 0) ? (uint8_t(1)) : (uint8_t(0)))
+#define _getFlags_A()  (((_rFv & B00010000) != 0) ? (uint8_t(1)) : (uint8_t(0)))
+#define _getFlags_P()  (((_rFv & B00000100) != 0) ? (uint8_t(1)) : (uint8_t(0)))
+#define _getFlags_C()  (((_rFv & B00000001) != 0) ? (uint8_t(1)) : (uint8_t(0)))
 
 //SZ000P00  SZP flags lookup table
 const static uint8_t PROGMEM SZP_table[] = {
@@ -102,98 +119,181 @@ const static uint8_t PROGMEM SZP_table[] = {
   B10000100, B10000000, B10000000, B10000100, B10000000, B10000100, B10000100, B10000000, B10000000, B10000100, B10000100, B10000000, B10000100, B10000000, B10000000, B10000100,
 };
 
-uint16_t breakpoint = 0xFFFF;
+//F after ALU operation
+//bits 5, 3, 1 are kept, S Z P from table, A and C by operation kind
+static inline uint8_t _flags_eval(uint8_t k, uint8_t a, uint8_t b, uint8_t r) {
+  uint8_t f;
+  uint8_t t;
+  f = (_rF & B00101010) | pgm_read_byte_near(SZP_table + r);
+  switch (k) {
+    case LF_ADD:
+      //b - operand without carry, a + t = r
+      t = r - a;
+      if ((a & B1111) + (b & B1111) > B1111) {
+        f = f | B00010000;
+      }
+      if ((r < a) && (r < t)) {
+        f = f | B00000001;
+      }
+      break;
+    case LF_SUB:
+      //a + t + 1 = r, t - inverted operand (with borrow)
+      t = r - a - 1;
+      if (uint16_t(a + t + 1) <= 0xFF) {
+        f = f | B00000001;
+      }
+      if ((a & 0xF) + (r & 0xF) > 0xF) {
+        f = f | B00010000;
+      }
+      break;
+    case LF_CMP:
+      if (a < b) {
+        f = f | B00000001;
+      }
+      t = b ^ 0xFF;
+      if ((a & 0xF) + (t & 0xF) > 0xF) {
+        f = f | B00010000;
+      }
+      break;
+    case LF_ANA:
+      //8080 - CY = 0, AC = bits 3 a OR b
+      if (((a & B1000) | (b & B1000)) != 0) {
+        f = f | B00010000;
+      }
+      break;
+    case LF_ORA:
+      break;
+    case LF_INR:
+      if ((r & 0x0F) == 0x00) {
+        f = f | B00010000;
+      }
+      break;
+    case LF_DCR:
+      if (!((r & 0x0F) == 0x0F)) {
+        f = f | B00010000;
+      }
+      break;
+  }
+  return f;
+}
+
+//F from last ALU operation
+uint8_t _flags_sync() {
+  if (_LF_OP != LF_NONE) {
+    _rF = _flags_eval(_LF_OP, _LF_A, _LF_B, _LF_R);
+    _LF_OP = LF_NONE;
+  }
+  return _rF;
+}
+
+const uint16_t BREAKPOINT_OFF = 0xFFFF;
+uint16_t breakpoint = BREAKPOINT_OFF;
 boolean breakpointFlag = false;
-bool INTE;
 boolean DEBUG;//debug mode flag
 
+//attention word debug & breakpoint bits <- DEBUG, breakpoint
+void atn_sync() {
+  uint8_t atn;
+  atn = ATN & ATN_EXIT;
+  if (DEBUG) {
+    atn = atn | ATN_DEBUG;
+  }
+  if (breakpoint != BREAKPOINT_OFF) {
+    atn = atn | ATN_BREAK;
+  }
+  ATN = atn;
+}
+
 uint16_t pc2a16() {
   uint16_t a16;
   _PC++;
-  a16 = _getMEM(_PC);
+  _AB = _PC;
+  _FETCH();
+  a16 = _DB;
   _PC++;
-  a16 = a16 + 256 * _getMEM(_PC);
+  _AB = _PC;
+  _FETCH();
+  a16 = a16 + 256 * _DB;
   return a16;
 }
 
 void pc2sp() {
-  _SP--;
-  _SP--;
-  _setMEM(_SP, lowByte(_PC));
-  _setMEM(_SP + 1, highByte(_PC));
+  _SP = _SP - 2;
+  _AB = _SP;
+  _WRMEM16(_PC);
 }
 
 void state() {
   char hex[2];
   clrlin();
-  Serial.print("A:");
+  Serial.print(F("A:"));
   sprintf(hex, "%02X", _Regs[_Reg_A]);
   Serial.print(hex);
-  Serial.print("   ");
-  Serial.print("B:");
+  Serial.print(F("   "));
+  Serial.print(F("B:"));
   sprintf(hex, "%02X", _Regs[_Reg_B]);
   Serial.print(hex);
-  Serial.print("   ");
-  Serial.print("C:");
+  Serial.print(F("   "));
+  Serial.print(F("C:"));
   sprintf(hex, "%02X", _Regs[_Reg_C]);
   Serial.print(hex);
-  Serial.print("   ");
-  Serial.print("D:");
+  Serial.print(F("   "));
+  Serial.print(F("D:"));
   sprintf(hex, "%02X", _Regs[_Reg_D]);
   Serial.print(hex);
-  Serial.println("   ");
+  Serial.println(F("   "));
   clrlin();
-  Serial.print("E:");
+  Serial.print(F("E:"));
   sprintf(hex, "%02X", _Regs[_Reg_E]);
   Serial.print(hex);
-  Serial.print("   ");
-  Serial.print("H:");
+  Serial.print(F("   "));
+  Serial.print(F("H:"));
   sprintf(hex, "%02X", _Regs[_Reg_H]);
   Serial.print(hex);
-  Serial.print("   ");
-  Serial.print("L:");
+  Serial.print(F("   "));
+  Serial.print(F("L:"));
   sprintf(hex, "%02X", _Regs[_Reg_L]);
   Serial.print(hex);
-  Serial.print("   ");
-  Serial.print("F: ");
+  Serial.print(F("   "));
+  Serial.print(F("F: "));
   if (_getFlags_S()==1) {
-    Serial.print("S");
+    Serial.print(F("S"));
   }
   else {
-    Serial.print(" ");
+    Serial.print(F(" "));
   }
   if (_getFlags_Z()==1) {
-    Serial.print("Z");
+    Serial.print(F("Z"));
   }
   else {
-    Serial.print(" ");
+    Serial.print(F(" "));
   }
   if (_getFlags_A()==1) {
-    Serial.print("A");
+    Serial.print(F("A"));
   }
   else {
-    Serial.print(" ");
+    Serial.print(F(" "));
   }
   if (_getFlags_P()==1) {
-    Serial.print("P");
+    Serial.print(F("P"));
   }
   else {
-    Serial.print(" ");
+    Serial.print(F(" "));
   }
   if (_getFlags_C()==1) {
-    Serial.print("C");
+    Serial.print(F("C"));
   }
   else {
-    Serial.print(" ");
+    Serial.print(F(" "));
   }
-  Serial.println("   ");
+  Serial.println(F("   "));
   clrlin();
   Serial.print(F("PC:"));
   sprintf(hex, "%02X", highByte(_PC));
   Serial.print(hex);
   sprintf(hex, "%02X", lowByte(_PC));
   Serial.print(hex);
-  Serial.print("   ");
+  Serial.print(F("   "));
   Serial.print(F("SP:"));
   sprintf(hex, "%02X", highByte(_SP));
   Serial.print(hex);
@@ -203,14 +303,14 @@ void state() {
   Serial.print(F("CMD: "));
   sprintf(hex, "%02X", _IR);
   Serial.print(hex);
-  Serial.println("");
+  Serial.println();
   //MMU map
   clrlin();
   Serial.print(F("MMU: "));
   for(int i=0;i<MMU_BLOCKS_NUM;i++) {
     Serial.print(MMU_MAP[i],DEC);
   }
-  Serial.println("");
+  Serial.println();
 }
 
 void _I8080_() {
@@ -218,7 +318,7 @@ void _I8080_() {
 }
 
 void _I8080_HLT() {
-  exitFlag = true;
+  ATN |= ATN_EXIT;
 }
 
 //NOP
@@ -227,7 +327,10 @@ void _I8080_NOP() {
 }
 
 
-void _I8080_MOV(uint8_t DDD, uint8_t SSS) {
+//register, register pair & condition operands are template parameters -
+//every do0xNN() gets its own copy, register selection at compile time
+template <uint8_t DDD, uint8_t SSS>
+void _I8080_MOV() {
   if (DDD == _Reg_M)
   {
     _TMP = _Regs[SSS];
@@ -253,17 +356,18 @@ void _I8080_MOV(uint8_t DDD, uint8_t SSS) {
 }
 
 //MVI
-void _I8080_MVI(uint8_t DDD) {
+template <uint8_t DDD>
+void _I8080_MVI() {
   _PC++;
   _AB = _PC;
   if (DDD != _Reg_M)
   {
-    _RDMEM();
+    _FETCH();
     _Regs[DDD] = _DB;
   }
   else
   {
-    _RDMEM();
+    _FETCH();
     _TMP = _DB;
     _AB = _rpHL;
     _DB = _TMP;
@@ -274,10 +378,11 @@ void _I8080_MVI(uint8_t DDD) {
 
 
 //LXI
-void _I8080_LXI(uint8_t rp) {
+template <uint8_t rp>
+void _I8080_LXI() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   switch (rp) {
     case _RP_BC:
       _rC = _DB;
@@ -294,7 +399,7 @@ void _I8080_LXI(uint8_t rp) {
   }
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   switch (rp) {
     case _RP_BC:
       _rB = _DB;
@@ -316,11 +421,11 @@ void _I8080_LXI(uint8_t rp) {
 void _I8080_LDA() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _Z = _DB;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _W = _DB;
   _AB = _rpWZ;
   _RDMEM();
@@ -332,11 +437,11 @@ void _I8080_LDA() {
 void _I8080_STA() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _Z = _DB;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _W = _DB;
   _AB = _rpWZ;
   _DB = _rA;
@@ -348,24 +453,19 @@ void _I8080_STA() {
 //LHLD
 void _I8080_LHLD()
 {
+  uint16_t d16;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _Z = _DB;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _W = _DB;
   _AB = _rpWZ;
-  _RDMEM();
-  _rL = _DB;
-  _Z++;
-  if (_Z == 0) {
-    _W++;
-  }
-  _AB = _rpWZ;
-  _RDMEM();
-  _rH = _DB;
+  d16 = _RDMEM16();
+  _rL = lowByte(d16);
+  _rH = highByte(d16);
   _PC++;
 }
 
@@ -373,27 +473,20 @@ void _I8080_LHLD()
 void _I8080_SHLD() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _Z = _DB;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _W = _DB;
   _AB = _rpWZ;
-  _DB = _rL;
-  _WRMEM();
-  _Z++;
-  if (_Z == 0) {
-    _W++;
-  }
-  _AB = _rpWZ;
-  _DB = _rH;
-  _WRMEM();
+  _WRMEM16(word(_rH, _rL));
   _PC++;
 }
 
 //LDAX
-void _I8080_LDAX(uint8_t rp) {
+template <uint8_t rp>
+void _I8080_LDAX() {
   switch (rp) {
     case _RP_BC:
       _AB = _rpBC;
@@ -408,7 +501,8 @@ void _I8080_LDAX(uint8_t rp) {
 }
 
 //STAX
-void _I8080_STAX(uint8_t rp) {
+template <uint8_t rp>
+void _I8080_STAX() {
   switch (rp) {
     case _RP_BC:
       _AB = _rpBC;
@@ -434,7 +528,8 @@ void _I8080_XCHG() {
 }
 
 //ADD
-void _I8080_ADD(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_ADD() {
   if (SSS != _Reg_M) {
     _TMP = _Regs[SSS];
     _ACT = _rA;
@@ -445,20 +540,8 @@ void _I8080_ADD(uint8_t SSS) {
     _RDMEM();
     _TMP = _DB;
   }
-  if ((_ACT & B1111) + (_TMP & B1111) > B1111) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
   _rA = _ACT + _TMP;
-  if ((_rA < _ACT) && (_rA < _TMP)) {
-    _setFlags_C(1);
-  }
-  else {
-    _setFlags_C(0);
-  }
-  _FLAGS(_rA);
+  _ALU_FLAGS(LF_ADD, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -467,28 +550,17 @@ void _I8080_ADI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
-  if ((_ACT & B1111) + (_TMP & B1111) > B1111) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
   _rA = _ACT + _TMP;
-  if ((_rA < _ACT) && (_rA < _TMP)) {
-    _setFlags_C(1);
-  }
-  else {
-    _setFlags_C(0);
-  }
-  _FLAGS(_rA);
+  _ALU_FLAGS(LF_ADD, _ACT, _TMP, _rA);
   _PC++;
 }
 
 
 //ADC
-void _I8080_ADC(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_ADC() {
   if (SSS != _Reg_M) {
     _TMP = _Regs[SSS];
     _ACT = _rA;
@@ -499,21 +571,9 @@ void _I8080_ADC(uint8_t SSS) {
     _RDMEM();
     _TMP = _DB;
   }
-  if ((_ACT & B1111) + (_TMP & B1111) > B1111) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
-  _TMP = _TMP + _getFlags_C();
-  _rA = _ACT + _TMP;
-  if ((_rA < _ACT) && (_rA < _TMP)) {
-    _setFlags_C(1);
-  }
-  else {
-    _setFlags_C(0);
-  }
-  _FLAGS(_rA);
+  _ALU = _TMP + _getFlags_C();
+  _rA = _ACT + _ALU;
+  _ALU_FLAGS(LF_ADD, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -522,28 +582,17 @@ void _I8080_ACI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
-  if ((_ACT & B1111) + (_TMP & B1111) > B1111) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
-  _TMP = _TMP + _getFlags_C();
-  _rA = _ACT + _TMP;
-  if ((_rA < _ACT) && (_rA < _TMP)) {
-    _setFlags_C(1);
-  }
-  else {
-    _setFlags_C(0);
-  }
-  _FLAGS(_rA);
+  _ALU = _TMP + _getFlags_C();
+  _rA = _ACT + _ALU;
+  _ALU_FLAGS(LF_ADD, _ACT, _TMP, _rA);
   _PC++;
 }
 
 //SUB
-void _I8080_SUB(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_SUB() {
   if (SSS != _Reg_M) {
     _TMP = _Regs[SSS];
     _ACT = _rA;
@@ -556,20 +605,7 @@ void _I8080_SUB(uint8_t SSS) {
   }
   _TMP = _TMP ^ 0xFF;
   _rA = _ACT + _TMP + 1;
-  if (uint16_t(_ACT + _TMP + 1) > 0xFF) {
-    _setFlags_C(0);
-  }
-  else
-  {
-    _setFlags_C(1);
-  }
-  _FLAGS(_rA);
-  if ((_ACT & 0xF) + (_rA & 0xF) > 0xF) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
+  _ALU_FLAGS(LF_SUB, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -578,30 +614,18 @@ void _I8080_SUI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
   _TMP = _TMP ^ 0xFF;
   _rA = _ACT + _TMP + 1;
-  if (uint16_t(_ACT + _TMP + 1) > 0xFF) {
-    _setFlags_C(0);
-  }
-  else
-  {
-    _setFlags_C(1);
-  }
-  _FLAGS(_rA);
-  if ((_ACT & 0xF) + (_rA & 0xF) > 0xF) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
+  _ALU_FLAGS(LF_SUB, _ACT, _TMP, _rA);
   _PC++;
   _AB = _PC;
 }
 
 //SBB
-void _I8080_SBB(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_SBB() {
   if (SSS != _Reg_M) {
     _TMP = _Regs[SSS];
     _ACT = _rA;
@@ -615,20 +639,7 @@ void _I8080_SBB(uint8_t SSS) {
   _TMP = _TMP + _getFlags_C();
   _TMP = _TMP ^ 0xFF;
   _rA = _ACT + _TMP + 1;
-  if (uint16_t(_ACT + _TMP + 1) > 0xFF) {
-    _setFlags_C(0);
-  }
-  else
-  {
-    _setFlags_C(1);
-  }
-  _FLAGS(_rA);
-  if ((_ACT & 0xF) + (_rA & 0xF) > 0xF) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
+  _ALU_FLAGS(LF_SUB, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -636,25 +647,12 @@ void _I8080_SBI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
   _TMP = _TMP + _getFlags_C();
   _TMP = _TMP ^ 0xFF;
   _rA = _ACT + _TMP + 1;
-  if (uint16_t(_ACT + _TMP + 1) > 0xFF) {
-    _setFlags_C(0);
-  }
-  else
-  {
-    _setFlags_C(1);
-  }
-  _FLAGS(_rA);
-  if ((_ACT & 0xF) + (_rA & 0xF) > 0xF) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
+  _ALU_FLAGS(LF_SUB, _ACT, _TMP, _rA);
   _PC++;
   _AB = _PC;
 }
@@ -664,7 +662,8 @@ void _I8080_SBI() {
 //instructions.
 
 //INR
-void _I8080_INR(uint8_t DDD) {
+template <uint8_t DDD>
+void _I8080_INR() {
   if (DDD == _Reg_M)
   {
     _AB = _rpHL;
@@ -684,19 +683,13 @@ void _I8080_INR(uint8_t DDD) {
   else {
     _Regs[DDD] = _ALU;
   }
-  _FLAGS(_ALU);
-  _setFlags_C(0);
-  if ((_ALU & 0x0F) == 0x00) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
+  _ALU_FLAGS(LF_INR, _TMP, 1, _ALU);
   _PC++;
 }
 
 //DCR
-void _I8080_DCR(uint8_t DDD) {
+template <uint8_t DDD>
+void _I8080_DCR() {
   if (DDD == _Reg_M)
   {
     _AB = _rpHL;
@@ -716,19 +709,13 @@ void _I8080_DCR(uint8_t DDD) {
   else {
     _Regs[DDD] = _ALU;
   }
-  _FLAGS(_ALU);
-  _setFlags_C(0);
-  if (!((_ALU & 0x0F) == 0x0F)) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
+  _ALU_FLAGS(LF_DCR, _TMP, 1, _ALU);
   _PC++;
 }
 
 //INX
-void _I8080_INX(uint8_t rp) {
+template <uint8_t rp>
+void _I8080_INX() {
   switch (rp)  {
     case _RP_BC:
       _rC++;
@@ -756,7 +743,8 @@ void _I8080_INX(uint8_t rp) {
 }
 
 //DCX
-void _I8080_DCX(uint8_t rp) {
+template <uint8_t rp>
+void _I8080_DCX() {
   switch (rp)  {
     case _RP_BC:
       _rC--;
@@ -784,7 +772,8 @@ void _I8080_DCX(uint8_t rp) {
 }
 
 //DAD
-void _I8080_DAD(uint8_t rp) {
+template <uint8_t rp>
+void _I8080_DAD() {
   uint16_t d16_1;
   uint16_t d16_2;
   uint16_t d16_3;
@@ -839,12 +828,13 @@ void _I8080_DAA() {
   }
   _rA = _rA + d8;
   //SZP flags
-  _rF = (_rF & ZP_RESET) | (pgm_read_byte_near(SZP_table + _rA) & B01111111);
+  _rF = (_rFv & ZP_RESET) | (pgm_read_byte_near(SZP_table + _rA) & B01111111);
   _PC++;
 }
 
 //ANA
-void _I8080_ANA(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_ANA() {
   if (SSS == _Reg_M)
   {
     _ACT = _rA;
@@ -858,17 +848,9 @@ void _I8080_ANA(uint8_t SSS) {
     _ACT = _rA;
   }
   //8080 - CY = 0, AC = bits 3 _rA OR d8
-  _setFlags_C(0);
-  if ( ((_ACT & B1000) | (_TMP & B1000)) != 0) {
-    _setFlags_A(1);
-  }
-  else
-  {
-    _setFlags_A(0);
-  }
   //8085 - CY = 0, AC = 1
   _rA = _ACT & _TMP;
-  _FLAGS(_rA);
+  _ALU_FLAGS(LF_ANA, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -877,24 +859,17 @@ void _I8080_ANI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
   //8080 - CY = 0, AC = bits 3 _rA OR d8
-  _setFlags_C(0);
-  if ( ((_ACT & B1000) | (_TMP & B1000)) != 0) {
-    _setFlags_A(1);
-  }
-  else
-  {
-    _setFlags_A(0);
-  }
   _rA = _ACT & _TMP;
-  _FLAGS(_rA);
+  _ALU_FLAGS(LF_ANA, _ACT, _TMP, _rA);
   _PC++;
 }
 
 //ORA
-void _I8080_ORA(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_ORA() {
   if (SSS == _Reg_M)
   {
     _ACT = _rA;
@@ -908,9 +883,7 @@ void _I8080_ORA(uint8_t SSS) {
     _ACT = _rA;
   }
   _rA = _ACT | _TMP;
-  _FLAGS(_rA);
-  _setFlags_C(0);
-  _setFlags_A(0);
+  _ALU_FLAGS(LF_ORA, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -919,17 +892,16 @@ void _I8080_ORI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
   _rA = _ACT | _TMP;
-  _FLAGS(_rA);
-  _setFlags_C(0);
-  _setFlags_A(0);
+  _ALU_FLAGS(LF_ORA, _ACT, _TMP, _rA);
   _PC++;
 }
 
 //XRA
-void _I8080_XRA(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_XRA() {
   if (SSS == _Reg_M)
   {
     _ACT = _rA;
@@ -943,9 +915,7 @@ void _I8080_XRA(uint8_t SSS) {
     _ACT = _rA;
   }
   _rA = _ACT ^ _TMP;
-  _FLAGS(_rA);
-  _setFlags_C(0);
-  _setFlags_A(0);
+  _ALU_FLAGS(LF_ORA, _ACT, _TMP, _rA);
   _PC++;
 }
 
@@ -954,17 +924,16 @@ void _I8080_XRI() {
   _PC++;
   _ACT = _rA;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
   _rA = _ACT ^ _TMP;
-  _FLAGS(_rA);
-  _setFlags_C(0);
-  _setFlags_A(0);
+  _ALU_FLAGS(LF_ORA, _ACT, _TMP, _rA);
   _PC++;
 }
 
 //CMP
-void _I8080_CMP(uint8_t SSS) {
+template <uint8_t SSS>
+void _I8080_CMP() {
   if (SSS != _Reg_M) {
     _ACT = _rA;
     _TMP = _Regs[SSS];
@@ -975,21 +944,7 @@ void _I8080_CMP(uint8_t SSS) {
     _RDMEM();
     _TMP = _DB;
   }
-  if (_rA < _TMP) {
-    _setFlags_C(1);
-  }
-  else {
-    _setFlags_C(0);
-  }
-  _TMP = _TMP ^ 0xFF;
-  if ((_ACT & 0xF) + (_TMP & 0xF) > 0xF) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
-  _TMP = _TMP + 1;
-  _FLAGS(lowByte(_ACT + _TMP));
+  _ALU_FLAGS(LF_CMP, _ACT, _TMP, _ACT - _TMP);
   _PC++;
 }
 
@@ -998,23 +953,9 @@ void _I8080_CPI() {
   _ACT = _rA;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _TMP = _DB;
-  if (_ACT < _TMP) {
-    _setFlags_C(1);
-  }
-  else {
-    _setFlags_C(0);
-  }
-  _TMP = _TMP ^ 0xFF;
-  if ((_ACT & 0xF) + (_TMP & 0xF) > 0xF) {
-    _setFlags_A(1);
-  }
-  else {
-    _setFlags_A(0);
-  }
-  _TMP = _TMP + 1;
-  _FLAGS(lowByte(_ACT + _TMP));
+  _ALU_FLAGS(LF_CMP, _ACT, _TMP, _ACT - _TMP);
   _PC++;
 }
 
@@ -1080,18 +1021,19 @@ void _I8080_STC() {
 void _I8080_JMP() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _Z = _DB;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _W = _DB;
   _PC = _rpWZ;
 }
 
 //Jccc
-void _I8080_JCCC(uint8_t CCC)
+template <uint8_t CCC>
+void _I8080_JCCC()
 {
   boolean COND = false;
   switch (CCC) {
@@ -1130,11 +1072,11 @@ void _I8080_JCCC(uint8_t CCC)
   }
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _Z = _DB;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _W = _DB;
   if (COND) {
@@ -1144,28 +1086,24 @@ void _I8080_JCCC(uint8_t CCC)
 
 //CALL
 void _I8080_CALL() {
-  _SP--;
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _Z = _DB;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _W = _DB;
+  _SP = _SP - 2;
   _AB = _SP;
-  _DB = highByte(_PC);
-  _WRMEM();
-  _SP--;
-  _AB = _SP;
-  _DB = lowByte(_PC);
-  _WRMEM();
+  _WRMEM16(_PC);
   _PC = _rpWZ;
 }
 
 //Cccc
-void _I8080_CCCC(uint8_t CCC) {
+template <uint8_t CCC>
+void _I8080_CCCC() {
   boolean COND = false;
   switch (CCC) {
     case B000: if (_getFlags_Z() == 0) {
@@ -1201,26 +1139,20 @@ void _I8080_CCCC(uint8_t CCC) {
       }
       break;
   }
-  if (COND) {
-    _SP--;
-  };
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _Z = _DB;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _PC++;
   _W = _DB;
   if (COND) {
+    _CLK_COND();
+    _SP = _SP - 2;
     _AB = _SP;
-    _DB = highByte(_PC);
-    _WRMEM();
-    _SP--;
-    _AB = _SP;
-    _DB = lowByte(_PC);
-    _WRMEM();
+    _WRMEM16(_PC);
     _PC = _rpWZ;
   }
 }
@@ -1228,21 +1160,21 @@ void _I8080_CCCC(uint8_t CCC) {
 //RET
 void _I8080_RET()
 {
+  uint16_t d16;
   _AB = _SP;
-  _RDMEM();
-  _SP++;
-  _Z = _DB;
-  _AB = _SP;
-  _RDMEM();
-  _SP++;
-  _W = _DB;
+  d16 = _RDMEM16();
+  _SP = _SP + 2;
+  _Z = lowByte(d16);
+  _W = highByte(d16);
   _PC = _rpWZ;
 }
 
 //Rccc
-void _I8080_RCCC(uint8_t CCC)
+template <uint8_t CCC>
+void _I8080_RCCC()
 {
   boolean COND = false;
+  uint16_t d16;
   switch (CCC) {
     case B000: if (_getFlags_Z() == 0) {
         COND = true;  //NZ
@@ -1278,14 +1210,12 @@ void _I8080_RCCC(uint8_t CCC)
       break;
   }
   if (COND) {
+    _CLK_COND();
     _AB = _SP;
-    _RDMEM();
-    _SP++;
-    _Z = _DB;
-    _AB = _SP;
-    _RDMEM();
-    _SP++;
-    _W = _DB;
+    d16 = _RDMEM16();
+    _SP = _SP + 2;
+    _Z = lowByte(d16);
+    _W = highByte(d16);
     _PC = _rpWZ;
   }
   else {
@@ -1294,7 +1224,8 @@ void _I8080_RCCC(uint8_t CCC)
 }
 
 //RST
-void _I8080_RST(uint8_t n) {
+template <uint8_t n>
+void _I8080_RST() {
   _PC++;
   pc2sp();
   _PC = n * 8;
@@ -1309,20 +1240,13 @@ void _I8080_PCHL() {
 
 //XTHL
 void _I8080_XTHL() {
+  uint16_t d16;
   _AB = _SP;
-  _RDMEM();
-  _SP++;
-  _Z = _DB;
-  _AB = _SP;
-  _RDMEM();
-  _W = _DB;
-  _AB = _SP;
-  _DB = _rH;
-  _WRMEM();
-  _SP--;
+  d16 = _RDMEM16();
+  _Z = lowByte(d16);
+  _W = highByte(d16);
   _AB = _SP;
-  _DB = _rL;
-  _WRMEM();
+  _WRMEM16(word(_rH, _rL));
   _rL = _Z;
   _rH = _W;
   _PC++;
@@ -1336,78 +1260,50 @@ void _I8080_SPHL()
 }
 
 //PUSH
-void _I8080_PUSH(uint8_t rp) {
-  _SP--;
+template <uint8_t rp>
+void _I8080_PUSH() {
+  _SP = _SP - 2;
   _AB = _SP;
-  _SP--;
   switch (rp)  {
     case _RP_BC:
-      _DB = _rB;
+      _WRMEM16(word(_rB, _rC));
       break;
     case _RP_DE:
-      _DB = _rD;
+      _WRMEM16(word(_rD, _rE));
       break;
     case _RP_AF:
-      _DB = _rA;
+      _WRMEM16(word(_rA, _rFv));
       break;
     case _RP_HL:
-      _DB = _rH;
+      _WRMEM16(word(_rH, _rL));
       break;
   }
-  _WRMEM();
-  _AB = _SP;
-  switch (rp)  {
-    case _RP_BC:
-      _DB = _rC;
-      break;
-    case _RP_DE:
-      _DB = _rE;
-      break;
-    case _RP_AF:
-      _DB = _rF;
-      break;
-    case _RP_HL:
-      _DB = _rL;
-      break;
-  }
-  _WRMEM();
   _PC++;
 }
 
 //POP
-void _I8080_POP(uint8_t rp) {
-  _AB = _SP;
-  _RDMEM();
-  _SP++;
-  switch (rp)  {
-    case _RP_BC:
-      _rC = _DB;
-      break;
-    case _RP_DE:
-      _rE = _DB;
-      break;
-    case _RP_AF:
-      _rF = _DB;
-      break;
-    case _RP_HL:
-      _rL = _DB;
-      break;
-  }
+template <uint8_t rp>
+void _I8080_POP() {
+  uint16_t d16;
   _AB = _SP;
-  _RDMEM();
-  _SP++;
+  d16 = _RDMEM16();
+  _SP = _SP + 2;
   switch (rp)  {
     case _RP_BC:
-      _rB = _DB;
+      _rC = lowByte(d16);
+      _rB = highByte(d16);
       break;
     case _RP_DE:
-      _rD = _DB;
+      _rE = lowByte(d16);
+      _rD = highByte(d16);
       break;
     case _RP_AF:
-      _rA = _DB;
+      _rF_SET(lowByte(d16));
+      _rA = highByte(d16);
       break;
     case _RP_HL:
-      _rH = _DB;
+      _rL = lowByte(d16);
+      _rH = highByte(d16);
       break;
   }
   _PC++;
@@ -1417,7 +1313,7 @@ void _I8080_POP(uint8_t rp) {
 void _I8080_IN() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _Z = _DB;
   _W = _DB;
   _AB = _rpWZ;
@@ -1430,7 +1326,7 @@ void _I8080_IN() {
 void _I8080_OUT() {
   _PC++;
   _AB = _PC;
-  _RDMEM();
+  _FETCH();
   _Z = _DB;
   _W = _DB;
   _AB = _rpWZ;
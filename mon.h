@@ -7,7 +7,7 @@
 //TO DO
 //command length check
 
-//LDOIFTBWQGSXCRMEZKYV
+//LDOIFTBWQGSXCRMEZKYVUPHA
 
     clrarea();//clear work area
     
@@ -17,7 +17,7 @@
         _AB = kbd2word(1);
         _DB = kbd2byte(5);
         _WRMEM();
-        Serial.println("O.K.");
+        Serial.println(F("O.K."));
         goto MON_END;
       }
       else {
@@ -46,7 +46,7 @@
         port = kbd2byte(1);
         dat = kbd2byte(3);
         _setPORT(port, dat);
-        Serial.println("O.K.");
+        Serial.println(F("O.K."));
         goto MON_END;
       }
       else {
@@ -138,7 +138,7 @@
                 hex_crc++;
                 if (hex_crc != dat) {
                   error = true;
-                  Serial.println("");
+                  Serial.println();
                   Serial.println(F("CRC error!"));
                   break;
                 }
@@ -189,7 +189,7 @@
       }
     } while ((!_EOF) && (!error));
     if (!error) {
-      Serial.println("");
+      Serial.println();
       Serial.print(hex_bytes, DEC);
       Serial.println(F(" byte(s) were successfully received"));  
     }
@@ -223,7 +223,7 @@
         delay(10);
       }
      } while (!_EOF);   
-     Serial.println("");
+     Serial.println();
      Serial.print(count, DEC);
      Serial.println(F(" byte(s) were successfully received"));  
      goto MON_END;
@@ -289,7 +289,7 @@
       tmp_byte=tmp_byte+_DB;
       adr++;
      }
-     Serial.println("");
+     Serial.println();
      if (crc==tmp_byte) {
       Serial.print(len, DEC);
       Serial.println(F(" byte(s) were successfully received")); 
@@ -323,6 +323,7 @@
       adr = kbd2word(1);
       if (breakpoint == adr) {
         //breakpoint off
+        breakpoint = BREAKPOINT_OFF;
         Serial.print(F("Breakpoint disabled"));
       }
       else {
@@ -390,7 +391,7 @@
       }
       else {
         Serial.println(F("Format disk"));
-        Serial.println("");
+        Serial.println();
         //format
         start = SD_FDD_OFFSET[driveno];
         for (uint32_t i = 0; i<SD_BLK_SIZE; i++) {
@@ -402,7 +403,7 @@
           Serial.print(i,DEC);
           res = card.writeBlock(i+start, _dsk_buffer);
         }
-        Serial.println("");
+        Serial.println();
       }
       Serial.println(F("O.K."));
       goto MON_END;
@@ -413,7 +414,7 @@
       DEBUG = false;//debug off 
       clrscr();//clear screen
       CPM_logo = true;
-      while (!_IPL()) {};//initial loader
+      while (!_IPL(true)) {};//initial loader
       CPM_logo = false;
       BIOS_INT = true;//BIOS intercept enabled
       MON = false;
@@ -433,6 +434,9 @@
       uint32_t pass_cnt=0;
       boolean go=true;
       uint32_t temp;
+#if RAM_DISK
+      uint8_t block;
+#endif
       con_flush();
       clrscr();//clear screen
       Serial.println(F("RAM TEST..."));
@@ -446,7 +450,7 @@
         }
         else {
                 pass_cnt++;
-                Serial.println("");
+                Serial.println();
                 clrlin();
                 Serial.print(F("PASS "));
                 Serial.print(pass_cnt, DEC);
@@ -460,6 +464,14 @@
                 }
         }
       } while (go);
+#if RAM_DISK
+      //RAM disk banks overwritten (Y mapping) - directory formatted again at boot
+      for (block = 0; block < MMU_BLOCKS_NUM; block++) {
+        if (bank_get(block) >= RD_BANK) {
+          RD_FORMAT = false;
+        }
+      }
+#endif
      goto MON_END;
     }
 
@@ -557,7 +569,7 @@
     if (mon_buffer[0]=='Y') {
       if (hexcheck(1,2)) {
         if (kbd2nibble(2)<MMU_BANKS_NUM) {
-          MMU_MAP[kbd2nibble(1)] = kbd2nibble(2);
+          bank_set(kbd2nibble(1), kbd2nibble(2));
           Serial.print(F("BLOCK "));
           Serial.print(kbd2nibble(1), HEX);
           Serial.print(F(":BANK "));
@@ -573,6 +585,84 @@
       }
     }
 
+    //P - emulated instructions rate
+    if (mon_buffer[0]=='P') {
+      Serial.println(F("BENCHMARK..."));
+      bench();
+      Serial.println(F("O.K."));
+      goto MON_END;
+    }
+
+    //H - T-states counter
+    //HXXXX - governor target, kHz (0000 - off)
+    if (mon_buffer[0]=='H') {
+      if (hexcheck(1,4)) {
+        CLK_KHZ = kbd2word(1);
+        Serial.print(F("GOVERNOR: "));
+        Serial.print(CLK_KHZ, DEC);
+        Serial.println(F(" KHZ"));
+        goto MON_END;
+      }
+      Serial.print(F("T-STATES: "));
+      Serial.println(CYCLES, DEC);
+      Serial.print(F("WAIT: "));
+      Serial.println(MEM_WAIT, DEC);
+      Serial.println(F("O.K."));
+      goto MON_END;
+    }
+
+    //A - cache statistics
+    //AX - cache replacement policy (0 - FIFO, 1 - CLOCK, 2 - 2Q), statistics reset
+    //AP - sequential prefetch on/off, statistics reset
+    if (mon_buffer[0]=='A') {
+      if (mon_buffer[1]=='P') {
+        CACHE.prefetch = !CACHE.prefetch;
+#if CACHE_SPLIT
+        ICACHE.prefetch = CACHE.prefetch;
+#endif
+        mem_stat_reset();
+      }
+      else if (hexcheck(1,1)) {
+        if (kbd2nibble(1) < CACHE_POLICIES_NUM) {
+          CACHE.policy = kbd2nibble(1);
+#if CACHE_SPLIT
+          ICACHE.policy = CACHE.policy;
+#endif
+          mem_stat_reset();
+        }
+        else {
+          Serial.println(F("POLICY NOT EXIST!"));
+          goto MON_END;
+        }
+      }
+      cache_stat();
+      Serial.println(F("O.K."));
+      goto MON_END;
+    }
+
+#if MEM_STAT
+    //U - memory statistics
+    //UR - memory statistics reset
+    if (mon_buffer[0]=='U') {
+      if (mon_buffer[1]=='R') {
+        mem_stat_reset();
+      }
+      mem_stat();
+      Serial.println(F("O.K."));
+      goto MON_END;
+    }
+#endif
+
+    //N - SRAM usage: static, stack low-water mark
+    if (mon_buffer[0]=='N') {
+      Serial.print(F("STATIC SRAM: "));
+      Serial.println(sram_static(), DEC);
+      Serial.print(F("FREE STACK (MIN): "));
+      Serial.println(stack_free(), DEC);
+      Serial.println(F("O.K."));
+      goto MON_END;
+    }
+
     //V - current state
     if (mon_buffer[0]=='V') {
       savecur();
@@ -0,0 +1,68 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//ATTENTION CHECK
+//call() exit points with the fast path batch (ATN_BATCH):
+//HLT - exit at HLT, no instruction after it; breakpoint - stop at it (CTRL-C in debug);
+//CTRL-\ read by IN - exit after at most ATN_BATCH - 1 further instructions
+//run.sh builds it with ATN_BATCH 1 and 8, exit code - failed checks number
+#include "sketch.h"
+
+const uint16_t T_CODE = 0x0100;//test code
+const uint16_t T_STACK = 0x0200;//test stack
+const uint8_t T_INR_B = 0x04;
+const uint8_t T_HLT = 0x76;
+const uint8_t T_IN = 0xDB;
+const uint8_t T_RUN = 32;//INR B run length
+
+//code: [IN data port] INR B x T_RUN, HLT, INR B x T_RUN
+//returns HLT address
+uint16_t code(bool in) {
+  uint16_t p;
+  uint8_t i;
+  p = T_CODE;
+  if (in) {
+    _setMEM(p++, T_IN);
+    _setMEM(p++, SIOA_CON_PORT_DATA);
+  }
+  for (i = 0; i < T_RUN; i++) {
+    _setMEM(p++, T_INR_B);
+  }
+  _setMEM(p, T_HLT);
+  for (i = 0; i < T_RUN; i++) {
+    _setMEM(p + 1 + i, T_INR_B);
+  }
+  return p;
+}
+
+//code run from T_CODE as by the monitor B command (debug off), B - instructions executed
+void run() {
+  _rB = 0;
+  _SP = T_STACK;
+  DEBUG = false;
+  MON = false;
+  call(T_CODE);
+  MON = true;
+  host_input = "";
+}
+
+int main() {
+  uint16_t hlt;
+  host_boot();
+  hlt = code(false);
+  run();
+  check((_PC == hlt) && (_rB == T_RUN), "HLT - exit at HLT, nothing run past it");
+  breakpoint = T_CODE + 10;
+  host_input = "\x03";//CTRL-C in debug mode
+  run();
+  breakpoint = BREAKPOINT_OFF;
+  check((_PC == T_CODE + 11) && (_rB == 11), "breakpoint - stop at it, only its instruction run");
+  code(true);
+  host_input = "\x1F";//CTRL-\ read
+  run();
+  check((_rB <= ATN_BATCH - 1) && (_PC == T_CODE + 2 + _rB), "CTRL-\\ - exit within ATN_BATCH - 1 instructions");
+  return host_fails;
+}
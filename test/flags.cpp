@@ -0,0 +1,384 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//FLAGS EXERCISER
+//every ALU, INR/DCR, DAD, DAA, rotate & carry opcode over all A and operand values,
+//input F - 0x02 & 0xD7 (POP PSW), without & after a pending ALU operation (ADD C);
+//PSW after each instruction (PUSH PSW) and the eight jump conditions are hashed per opcode;
+//A, F, B, HL without a pending operation checked against ref() - baseline per-op flag code
+//(_I8080_ADD.._I8080_STC before LAZY_FLAGS), known 8080 results checked for edge cases
+//run.sh builds it with LAZY_FLAGS 0 and 1 and compares the output line by line
+#include "sketch.h"
+
+const uint16_t T_CODE = 0x0100;//test code
+const uint16_t T_STACK = 0x0200;//test stack
+const uint8_t T_POP_PSW = 0xF1;
+const uint8_t T_PUSH_PSW = 0xF5;
+const uint8_t T_ADD_C = 0x81;
+const uint8_t T_ORA_E = 0xB3;
+const uint8_t T_NOP = 0x00;
+const uint16_t T_TAKEN = 0x1000;//jump target
+
+//opcodes under test: with B / immediate operand, or no operand (A only / HL, BC)
+const uint8_t T_OPS[] = {
+  0x80, 0x88, 0x90, 0x98, 0xA0, 0xA8, 0xB0, 0xB8,//ADD..CMP B
+  0x87, 0x8F, 0x97, 0x9F, 0xA7, 0xAF, 0xB7, 0xBF,//ADD..CMP A
+  0xC6, 0xCE, 0xD6, 0xDE, 0xE6, 0xEE, 0xF6, 0xFE,//ADI..CPI
+  0x04, 0x05, 0x3C, 0x3D,//INR B, DCR B, INR A, DCR A
+  0x09, 0x19, 0x29, 0x39,//DAD B, D, H, SP
+  0x27, 0x07, 0x0F, 0x17, 0x1F,//DAA, RLC, RRC, RAL, RAR
+  0x2F, 0x37, 0x3F,//CMA, STC, CMC
+};
+//conditional jumps JNZ JZ JNC JC JPO JPE JP JM
+const uint8_t T_JMP[] = { 0xC2, 0xCA, 0xD2, 0xDA, 0xE2, 0xEA, 0xF2, 0xFA };
+
+//known 8080 results (Intel 8080 Assembly Language Programming Manual examples & edge cases),
+//mask - flags compared; baseline differences kept by the emulator are masked out:
+//AC of SUB/SBB/CMP - low nibbles of A and result (A and ~operand for CMP) added, no +1,
+//AC of ADC - carry-in not added, ADC/SBB operand + CY wraps to 0 (CY lost),
+//DAA keeps S
+struct vec_t {
+  uint8_t op;
+  uint8_t a;
+  uint8_t f;
+  uint8_t b;//B / immediate operand
+  uint8_t ra;//A after
+  uint8_t rf;//F after
+  uint8_t mask;
+};
+const uint8_t F_ALL = 0xD7;
+const uint8_t F_AC = 0x10;
+const uint8_t F_CY = 0x01;
+const uint8_t F_S = 0x80;
+const vec_t T_VEC[] = {
+  { 0x80, 0x6C, 0x02, 0x2E, 0x9A, 0x96, F_ALL },//ADD B: S, AC, P
+  { 0x80, 0xFF, 0x02, 0x01, 0x00, 0x57, F_ALL },//ADD B: Z, AC, P, CY
+  { 0xC6, 0x14, 0xD7, 0x42, 0x56, 0x06, F_ALL },//ADI: flags cleared
+  { 0x88, 0x42, 0x02, 0x3D, 0x7F, 0x02, F_ALL },//ADC B, CY = 0
+  { 0x88, 0x42, 0x03, 0x3D, 0x80, 0x92, F_ALL & ~F_AC },//ADC B, CY = 1: S, AC
+  { 0x88, 0x00, 0x03, 0xFF, 0x00, 0x57, F_ALL & ~(F_AC | F_CY) },//ADC B, CY = 1: 0xFF + 1 wraps
+  { 0x97, 0x3E, 0xD7, 0x00, 0x00, 0x56, F_ALL & ~F_AC },//SUB A: Z, P, CY cleared
+  { 0x90, 0x00, 0x02, 0x01, 0xFF, 0x87, F_ALL },//SUB B: borrow
+  { 0xD6, 0x00, 0x02, 0x01, 0xFF, 0x87, F_ALL },//SUI: borrow
+  { 0x98, 0x04, 0x03, 0x02, 0x01, 0x12, F_ALL & ~F_AC },//SBB B, CY = 1
+  { 0x98, 0x10, 0x03, 0xFF, 0x10, 0x03, F_ALL & ~(F_AC | F_CY) },//SBB B, CY = 1: 0xFF + 1 wraps
+  { 0xB8, 0x0A, 0x02, 0x05, 0x0A, 0x16, F_ALL },//CMP B: A > B
+  { 0xB8, 0x02, 0x02, 0x05, 0x02, 0x83, F_ALL },//CMP B: A < B
+  { 0xB8, 0x05, 0x02, 0x05, 0x05, 0x56, F_ALL & ~F_AC },//CMP B: A = B
+  { 0xFE, 0x4A, 0x02, 0x40, 0x4A, 0x16, F_ALL },//CPI
+  { 0xA0, 0xFC, 0x03, 0x0F, 0x0C, 0x16, F_ALL },//ANA B: AC - bit 3 of A or B
+  { 0xE6, 0xF0, 0x03, 0x07, 0x00, 0x46, F_ALL },//ANI: Z, bit 3 clear in both - no AC
+  { 0xAF, 0x5A, 0xD7, 0x00, 0x00, 0x46, F_ALL },//XRA A: Z, P, AC & CY cleared
+  { 0xB0, 0x33, 0x13, 0x0F, 0x3F, 0x06, F_ALL },//ORA B: P, AC & CY cleared
+  { 0x3C, 0xFF, 0x02, 0x00, 0x00, 0x56, F_ALL },//INR A: Z, AC, P
+  { 0x3C, 0x7F, 0x02, 0x00, 0x80, 0x92, F_ALL },//INR A: S, AC
+  { 0x3C, 0x0F, 0x03, 0x00, 0x10, 0x13, F_ALL & ~F_CY },//INR A: CY kept by 8080, cleared here
+  { 0x3D, 0x00, 0x02, 0x00, 0xFF, 0x86, F_ALL },//DCR A: S, P, no AC
+  { 0x3D, 0x01, 0x02, 0x00, 0x00, 0x56, F_ALL },//DCR A: Z, AC, P
+  { 0x3D, 0x10, 0x03, 0x00, 0x0F, 0x07, F_ALL & ~F_CY },//DCR A: borrow from bit 4, CY kept by 8080
+  { 0x27, 0x9B, 0x02, 0x00, 0x01, 0x13, F_ALL & ~F_S },//DAA: both nibbles adjusted
+  { 0x27, 0x15, 0x12, 0x00, 0x1B, 0x06, F_ALL & ~F_S },//DAA: AC in
+  { 0x27, 0x99, 0x02, 0x00, 0x99, 0x86, F_ALL & ~F_S },//DAA: no adjust
+  { 0x27, 0x00, 0x13, 0x00, 0x66, 0x07, F_ALL & ~F_S },//DAA: AC & CY in
+  { 0x07, 0xF2, 0x02, 0x00, 0xE5, 0x03, F_ALL },//RLC
+  { 0x0F, 0xF2, 0x03, 0x00, 0x79, 0x02, F_ALL },//RRC
+  { 0x17, 0xB5, 0x02, 0x00, 0x6A, 0x03, F_ALL },//RAL
+  { 0x1F, 0x6A, 0x03, 0x00, 0xB5, 0x02, F_ALL },//RAR
+  { 0x2F, 0x51, 0xD7, 0x00, 0xAE, 0xD7, F_ALL },//CMA: flags kept
+  { 0x3F, 0x00, 0xD7, 0x00, 0x00, 0xD6, F_ALL },//CMC
+  { 0x37, 0x00, 0x02, 0x00, 0x00, 0x03, F_ALL },//STC
+};
+
+uint32_t crc;
+//ref() results
+uint8_t ref_a;
+uint8_t ref_f;
+uint8_t ref_b;
+uint16_t ref_hl;
+
+void hash(uint8_t d) {
+  uint8_t i;
+  crc = crc ^ d;
+  for (i = 0; i < 8; i++) {
+    crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320UL : 0);
+  }
+}
+
+//S, Z, P of a result
+uint8_t szp(uint8_t r) {
+  uint8_t f;
+  uint8_t i;
+  f = 0x04;
+  for (i = 0; i < 8; i++) {
+    f = f ^ (((r >> i) & 1) << 2);
+  }
+  if (r == 0) {
+    f = f | 0x40;
+  }
+  return f | (r & 0x80);
+}
+
+//baseline per-op flag code, registers as set by run(), F - no pending operation
+void ref(uint8_t op, uint8_t a, uint8_t f, uint8_t b) {
+  uint8_t t;
+  uint8_t r;
+  uint8_t c;
+  uint8_t ac;
+  uint8_t cy;
+  uint8_t d8;
+  uint16_t rp;
+  c = f & 1;
+  ref_a = a;
+  ref_f = f;
+  ref_b = b;
+  ref_hl = word(a, b);
+  //operand: B, A or immediate
+  t = ((op & 0xC7) == 0x87) ? a : b;
+  ac = 0;
+  cy = 0;
+  switch (op & 0xF8) {
+    case 0x80://ADD
+    case 0x88://ADC
+      ac = ((a & 0x0F) + (t & 0x0F) > 0x0F);
+      if (op & 0x08) {
+        t = t + c;
+      }
+      r = a + t;
+      cy = (r < a) && (r < t);
+      ref_a = r;
+      ref_f = (f & 0x2A) | szp(r) | (ac << 4) | cy;
+      return;
+    case 0x90://SUB
+    case 0x98://SBB
+      if (op & 0x08) {
+        t = t + c;
+      }
+      t = t ^ 0xFF;
+      r = a + t + 1;
+      cy = !(uint16_t(a + t + 1) > 0xFF);
+      ac = ((a & 0x0F) + (r & 0x0F) > 0x0F);
+      ref_a = r;
+      ref_f = (f & 0x2A) | szp(r) | (ac << 4) | cy;
+      return;
+    case 0xA0://ANA
+      r = a & t;
+      ac = (((a | t) & 0x08) != 0);
+      ref_a = r;
+      ref_f = (f & 0x2A) | szp(r) | (ac << 4);
+      return;
+    case 0xA8://XRA
+    case 0xB0://ORA
+      r = (op & 0x10) ? (a | t) : (a ^ t);
+      ref_a = r;
+      ref_f = (f & 0x2A) | szp(r);
+      return;
+    case 0xB8://CMP
+      cy = (a < t);
+      t = t ^ 0xFF;
+      ac = ((a & 0x0F) + (t & 0x0F) > 0x0F);
+      ref_f = (f & 0x2A) | szp(a + t + 1) | (ac << 4) | cy;
+      return;
+  }
+  switch (op) {
+    case 0xC6: ref(0x80, a, f, b); return;//ADI..CPI as with B
+    case 0xCE: ref(0x88, a, f, b); return;
+    case 0xD6: ref(0x90, a, f, b); return;
+    case 0xDE: ref(0x98, a, f, b); return;
+    case 0xE6: ref(0xA0, a, f, b); return;
+    case 0xEE: ref(0xA8, a, f, b); return;
+    case 0xF6: ref(0xB0, a, f, b); return;
+    case 0xFE: ref(0xB8, a, f, b); return;
+    case 0x04://INR B, INR A
+    case 0x3C:
+      t = (op == 0x04) ? b : a;
+      r = t + 1;
+      ac = ((r & 0x0F) == 0x00);
+      break;
+    case 0x05://DCR B, DCR A
+    case 0x3D:
+      t = (op == 0x05) ? b : a;
+      r = t - 1;
+      ac = !((r & 0x0F) == 0x0F);
+      break;
+    case 0x09://DAD B, D, H, SP
+    case 0x19:
+    case 0x29:
+    case 0x39:
+      rp = (op == 0x09) ? word(b, b ^ 0x5A) : (op == 0x19) ? word(b, a ^ 0xA5) : (op == 0x29) ? word(a, b) : T_STACK;
+      ref_hl = ref_hl + rp;
+      cy = (ref_hl < word(a, b)) || (ref_hl < rp);
+      ref_f = (f & 0xFE) | cy;
+      return;
+    case 0x27://DAA
+      d8 = 0;
+      if (((a & 0x0F) > 9) || (f & 0x10)) {
+        f = (f & 0xEF) | (((a & 0x0F) > 9) << 4);
+        d8 = 6;
+      }
+      if (((a >> 4) > 9) || c || (((a >> 4) >= 9) && ((a & 0x0F) > 9))) {
+        if (((a >> 4) > 9) || (((a >> 4) >= 9) && ((a & 0x0F) > 9))) {
+          f = f | 1;
+        }
+        d8 = d8 | 0x60;
+      }
+      ref_a = a + d8;
+      ref_f = (f & 0xBB) | (szp(ref_a) & 0x7F);
+      return;
+    case 0x07://RLC
+      ref_a = (a << 1) | (a >> 7);
+      ref_f = (f & 0xFE) | (a >> 7);
+      return;
+    case 0x0F://RRC
+      ref_a = (a >> 1) | (a << 7);
+      ref_f = (f & 0xFE) | (a & 1);
+      return;
+    case 0x17://RAL
+      ref_a = (a << 1) | c;
+      ref_f = (f & 0xFE) | (a >> 7);
+      return;
+    case 0x1F://RAR
+      ref_a = (a >> 1) | (c << 7);
+      ref_f = (f & 0xFE) | (a & 1);
+      return;
+    case 0x2F://CMA
+      ref_a = ~a;
+      return;
+    case 0x37://STC
+      ref_f = f | 1;
+      return;
+    case 0x3F://CMC
+      ref_f = f ^ 1;
+      return;
+  }
+  //INR, DCR - CY cleared (baseline)
+  if ((op & 0x38) == 0) {
+    ref_b = r;
+  }
+  else {
+    ref_a = r;
+  }
+  ref_f = (f & 0x2A) | szp(r) | (ac << 4);
+}
+
+//test code: ORA E (pending operation dropped by POP PSW), POP PSW, NOP / ADD C, op [operand], PUSH PSW / Jcc
+//returns code address of the operand (0 - no operand)
+uint16_t code(uint8_t op, bool pre, int8_t jmp) {
+  uint16_t p;
+  uint16_t imm;
+  p = T_CODE;
+  _setMEM(p++, T_ORA_E);
+  _setMEM(p++, T_POP_PSW);
+  _setMEM(p++, pre ? T_ADD_C : T_NOP);
+  _setMEM(p++, op);
+  imm = 0;
+  if ((op & 0xC7) == 0xC6) {
+    imm = p++;
+  }
+  if (jmp < 0) {
+    _setMEM(p, T_PUSH_PSW);
+  }
+  else {
+    _setMEM(p, T_JMP[jmp]);
+    _setMEM(p + 1, lowByte(T_TAKEN));
+    _setMEM(p + 2, highByte(T_TAKEN));
+  }
+  return imm;
+}
+
+//one test run, A & F from the stack, B C D E H L from the operand
+//returns pushed F (and A, H, L hashed) or jump taken flag
+uint8_t run(uint16_t imm, uint8_t a, uint8_t f, uint8_t b, bool push) {
+  uint8_t n;
+  if (imm != 0) {
+    _setMEM(imm, b);
+  }
+  _setMEM(T_STACK - 2, f);
+  _setMEM(T_STACK - 1, a);
+  _SP = T_STACK - 2;
+  _rB = b;
+  _rC = b ^ 0x5A;
+  _rD = b;
+  _rE = a ^ 0xA5;
+  _rH = a;
+  _rL = b;
+  _PC = T_CODE;
+  for (n = 0; n < 5; n++) {
+    host_step();
+  }
+  if (push) {
+    hash(_rA);
+    hash(_rH);
+    hash(_rL);
+    return _getMEM(_SP);
+  }
+  return (_PC == T_TAKEN) ? 1 : 0;
+}
+
+int main() {
+  uint8_t k;
+  uint16_t a;
+  uint16_t b;
+  uint16_t imm;
+  uint8_t f;
+  uint8_t pre;
+  int8_t j;
+  uint32_t n;
+  uint8_t fl;
+  uint32_t bad;
+  uint8_t v;
+  host_boot();
+  bad = 0;
+  for (k = 0; k < sizeof(T_OPS); k++) {
+    crc = 0xFFFFFFFFUL;
+    n = 0;
+    for (pre = 0; pre < 2; pre++) {
+      //PSW after the operation
+      imm = code(T_OPS[k], pre, -1);
+      for (f = 0; f < 2; f++) {
+        for (a = 0; a < 256; a++) {
+          for (b = 0; b < 256; b++) {
+            fl = run(imm, a, f ? 0xD7 : 0x02, b, true);
+            hash(fl);
+            n++;
+            if (pre == 0) {
+              ref(T_OPS[k], a, f ? 0xD7 : 0x02, b);
+              if ((_rA != ref_a) || (fl != ref_f) || (_rB != ref_b) || (word(_rH, _rL) != ref_hl)) {
+                if (bad == 0) {
+                  printf("%02X A=%02X F=%02X B=%02X: A=%02X F=%02X, baseline A=%02X F=%02X\n", T_OPS[k], a, f ? 0xD7 : 0x02, b, _rA, fl, ref_a, ref_f);
+                }
+                bad++;
+              }
+            }
+          }
+        }
+      }
+    }
+    //conditions read straight from a pending operation
+    for (j = 0; j < 8; j++) {
+      imm = code(T_OPS[k], true, j);
+      for (a = 0; a < 256; a++) {
+        for (b = 0; b < 256; b++) {
+          hash(run(imm, a, 0x02, b, false));
+          n++;
+        }
+      }
+    }
+    printf("%02X %lu %08lX\n", T_OPS[k], (unsigned long)n, (unsigned long)(crc ^ 0xFFFFFFFFUL));
+  }
+  check(bad == 0, "baseline per-op flag code - A, F, B, HL of every opcode");
+  //edge cases
+  bad = 0;
+  for (v = 0; v < sizeof(T_VEC) / sizeof(T_VEC[0]); v++) {
+    imm = code(T_VEC[v].op, false, -1);
+    fl = run(imm, T_VEC[v].a, T_VEC[v].f, T_VEC[v].b, true);
+    if ((_rA != T_VEC[v].ra) || ((fl ^ T_VEC[v].rf) & T_VEC[v].mask)) {
+      printf("%02X A=%02X F=%02X B=%02X: A=%02X F=%02X, 8080 A=%02X F=%02X\n", T_VEC[v].op, T_VEC[v].a, T_VEC[v].f, T_VEC[v].b, _rA, fl, T_VEC[v].ra, T_VEC[v].rf);
+      bad++;
+    }
+  }
+  check(bad == 0, "8080 results - S, Z, AC, P, CY of ALU, INR/DCR, DAA & rotate edge cases");
+  return host_fails;
+}
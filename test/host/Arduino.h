@@ -0,0 +1,112 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//Arduino core stand-in: types, macros, pins, time, serial console
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binary.h"//B00000000..B11111111, generated by run.sh
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+static inline uint16_t makeWord(uint8_t h, uint8_t l) { return (uint16_t)((h << 8) | l); }
+static inline uint16_t makeWord(uint16_t w) { return w; }
+#define word(...) makeWord(__VA_ARGS__)
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define HEX 16
+#define DEC 10
+#define BIN 2
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+//string - characters only
+class String {
+  public:
+    String(const char* c = "") : s(c) {}
+    unsigned int length() const { return strlen(s); }
+    char charAt(unsigned int i) const { return s[i]; }
+  private:
+    const char* s;
+};
+
+//program memory - plain memory
+#define PROGMEM
+#define F(x) (x)
+#define _BV(b) (1 << (b))
+#define pgm_read_byte_near(p) (*(const uint8_t*)(p))
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+template<class T> static inline T pgm_read_word(const T* p) { return *p; }
+
+//interrupts & Timer1 registers
+#define ISR(v) void v()
+static inline void cli() {}
+static inline void sei() {}
+extern uint8_t TCCR1A, TCCR1B, TIMSK1;
+extern uint16_t TCNT1, OCR1A;
+#define WGM12 3
+#define CS12 2
+#define CS10 0
+#define OCIE1A 1
+
+//AVR stack pointer & SRAM start - macros as in avr-libc <avr/io.h>,
+//so sketch names clashing with them fail here too;
+//SP - ATmega328P RAMEND, below any host address (stack painting & counting do nothing)
+inline volatile uint16_t HOST_SP_REG = 0x08FF;
+#define SP (*(volatile uint16_t*)(&HOST_SP_REG))
+#define RAMSTART (0x100)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+#define fastDigitalWrite(p, v) digitalWrite(p, v)
+
+//serial console - input queue, output to stdout (or dropped)
+struct HostSerial {
+  void begin(long) {}
+  explicit operator bool() const { return true; }
+  int available();
+  int read();
+  void flush() {}
+  size_t write(uint8_t c);
+  size_t write(const char* s) { size_t n = 0; while (*s) { write((uint8_t)*s++); n++; } return n; }
+  size_t write(char c) { return write((uint8_t)c); }
+  size_t write(int c) { return write((uint8_t)c); }
+  void num(unsigned long v, int base) {
+    char b[40];
+    int i = 39;
+    b[i] = 0;
+    do { b[--i] = "0123456789ABCDEF"[v % base]; v = v / base; } while (v != 0);
+    write(b + i);
+  }
+  void print(const char* s) { write(s); }
+  void print(char c) { write((uint8_t)c); }
+  void print(unsigned char v, int base = DEC) { num(v, base); }
+  void print(int v, int base = DEC) { if ((v < 0) && (base == DEC)) { write('-'); v = -v; } num((unsigned)v, base); }
+  void print(unsigned int v, int base = DEC) { num(v, base); }
+  void print(long v, int base = DEC) { if ((v < 0) && (base == DEC)) { write('-'); v = -v; } num((unsigned long)v, base); }
+  void print(unsigned long v, int base = DEC) { num(v, base); }
+  template<class T> void println(T v) { print(v); write("\r\n"); }
+  template<class T> void println(T v, int base) { print(v, base); write("\r\n"); }
+  void println() { write("\r\n"); }
+};
+extern HostSerial Serial;
@@ -0,0 +1,18 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//EEPROM stand-in - 1K cells, blank (0xFF)
+#pragma once
+#include "Arduino.h"
+
+struct EEPROMClass {
+  uint8_t cell[1024];
+  EEPROMClass() { memset(cell, 0xFF, sizeof(cell)); }
+  uint8_t read(int idx) { return cell[idx]; }
+  void write(int idx, uint8_t val) { cell[idx] = val; }
+};
+extern EEPROMClass EEPROM;
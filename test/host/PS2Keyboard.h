@@ -0,0 +1,10 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//PS/2 keyboard not used
+#pragma once
+#include "Arduino.h"
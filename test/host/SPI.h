@@ -0,0 +1,84 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//SPI bus stand-in with 23K256 SPI SRAM on it
+//SpiRAM.cpp runs unchanged: chip select by digitalWrite(SRAM_SS_pin),
+//commands READ, WRITE, RDSR, WRSR byte by byte through SPI.transfer()
+#pragma once
+#include "Arduino.h"
+
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV16 0x01
+#define SPI_CLOCK_DIV64 0x02
+#define SPI_CLOCK_DIV128 0x03
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV32 0x06
+#define SPI_MODE0 0x00
+
+//23K256 model
+const uint8_t SRAM_SS_pin = 6;//chip select (L2_SS_pin, MEM.h)
+const uint16_t SRAM_SIZE = 32768;//32K x 8
+const uint16_t SRAM_PAGE = 32;//page size
+const uint8_t SRAM_READ = 0x03;
+const uint8_t SRAM_WRITE = 0x02;
+const uint8_t SRAM_RDSR = 0x05;
+const uint8_t SRAM_WRSR = 0x01;
+
+struct SRAM23K256 {
+  enum { IDLE, CMD, ADR_HI, ADR_LO, DATA, SR_IN, SR_OUT, DONE };
+  uint8_t mem[SRAM_SIZE];
+  uint8_t status = 0x00;//mode bits 7..6: 00 - byte, 10 - page, 01 - stream
+  uint8_t state = IDLE;
+  uint8_t cmd = 0;
+  uint16_t adr = 0;
+  uint32_t reads = 0;//READ commands
+  uint32_t writes = 0;//WRITE commands
+  SRAM23K256() { memset(mem, 0x5A, sizeof(mem)); }//power-up contents
+  void select(bool on) { state = on ? CMD : IDLE; }
+  uint8_t transfer(uint8_t d) {
+    uint8_t q = 0xFF;
+    switch (state) {
+      case CMD:
+        cmd = d;
+        if ((d == SRAM_READ) || (d == SRAM_WRITE)) {
+          state = ADR_HI;
+          if (d == SRAM_READ) { reads++; } else { writes++; }
+        }
+        else if (d == SRAM_RDSR) { state = SR_OUT; }
+        else if (d == SRAM_WRSR) { state = SR_IN; }
+        else { state = DONE; }
+        break;
+      case ADR_HI: adr = (uint16_t)(d << 8); state = ADR_LO; break;
+      case ADR_LO: adr = (adr | d) & (SRAM_SIZE - 1); state = DATA; break;
+      case DATA:
+        if (cmd == SRAM_READ) { q = mem[adr]; } else { mem[adr] = d; }
+        switch (status & 0xC0) {
+          case 0x00: state = DONE; break;//byte mode - one byte per command
+          case 0x80: adr = (adr & ~(SRAM_PAGE - 1)) | ((adr + 1) & (SRAM_PAGE - 1)); break;
+          default: adr = (adr + 1) & (SRAM_SIZE - 1); break;
+        }
+        break;
+      case SR_IN: status = d; state = DONE; break;
+      case SR_OUT: q = status; break;
+      default: break;
+    }
+    return q;
+  }
+};
+extern SRAM23K256 SRAM;
+
+class SPIClass {
+  public:
+    static uint8_t transfer(uint8_t d) { return SRAM.transfer(d); }
+    static void begin() {}
+    static void end() {}
+    static void setBitOrder(uint8_t) {}
+    static void setDataMode(uint8_t) {}
+    static void setClockDivider(uint8_t) {}
+};
+extern SPIClass SPI;
@@ -0,0 +1,70 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//SD card stand-in - 512-byte sectors in memory, never written sectors read as zeros
+//(the SD bus is not modelled, SPI transfers go to the 23K256 only)
+#pragma once
+#include "Arduino.h"
+#include <map>
+#include <array>
+
+#define SPI_FULL_SPEED 0
+#define SPI_HALF_SPEED 1
+#define SPI_QUARTER_SPEED 2
+
+typedef std::array<uint8_t, 512> sd_sec_t;
+const uint8_t SD_FAIL_READ = 0x01;
+const uint8_t SD_FAIL_WRITE = 0x02;
+const uint8_t SD_FAIL_ERASE = 0x04;
+
+class Sd2Card {
+  public:
+    std::map<uint32_t, sd_sec_t> sec;//written sectors
+    uint32_t reads = 0;//read commands
+    uint32_t writes = 0;//written blocks
+    uint8_t partial = 0;
+    uint32_t wr_blk = 0;
+    uint8_t fail = 0;//failing commands (SD_FAIL_...) - error paths
+    uint8_t init(uint8_t, uint8_t) { return 1; }
+    uint32_t cardSize() { return 4000000UL; }
+    uint8_t errorCode() const { return 0; }
+    sd_sec_t& at(uint32_t blk) {
+      auto it = sec.find(blk);
+      if (it == sec.end()) {
+        sd_sec_t z;
+        z.fill(0);
+        it = sec.emplace(blk, z).first;
+      }
+      return it->second;
+    }
+    uint8_t erase(uint32_t first, uint32_t last) {
+      if (fail & SD_FAIL_ERASE) { return 0; }
+      for (uint32_t b = first; b <= last; b++) { sec.erase(b); }
+      return 1;
+    }
+    void partialBlockRead(uint8_t v) { partial = v; }
+    uint8_t partialBlockRead() const { return partial; }
+    void readEnd() {}
+    uint8_t readData(uint32_t blk, uint16_t offset, uint16_t count, uint8_t* dst) {
+      if ((offset + count > 512) || (fail & SD_FAIL_READ)) { return 0; }
+      reads++;
+      memcpy(dst, at(blk).data() + offset, count);
+      return 1;
+    }
+    uint8_t readBlock(uint32_t blk, uint8_t* dst, uint16_t offset) { return readData(blk, offset, 128, dst); }
+    uint8_t writeBlock(uint32_t blk, const uint8_t* src, uint16_t count = 128) {
+      if (fail & SD_FAIL_WRITE) { return 0; }
+      writes++;
+      sd_sec_t& s = at(blk);
+      memcpy(s.data(), src, count);
+      memset(s.data() + count, 0, 512 - count);
+      return 1;
+    }
+    uint8_t writeStart(uint32_t blk, uint32_t) { wr_blk = blk; return 1; }
+    uint8_t writeData(const uint8_t* src) { return writeBlock(wr_blk++, src); }
+    uint8_t writeStop() { return 1; }
+};
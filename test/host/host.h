@@ -0,0 +1,61 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//globals of the stand-ins, included once before the sketch
+#pragma once
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "SPI.h"
+#include "Sd2Card.h"
+#include <chrono>
+
+uint8_t TCCR1A, TCCR1B, TIMSK1;
+uint16_t TCNT1, OCR1A;
+HostSerial Serial;
+EEPROMClass EEPROM;
+SRAM23K256 SRAM;
+SPIClass SPI;
+char __heap_start;//AVR linker symbol stand-in
+char* __brkval = 0;//avr-libc heap end stand-in
+
+bool host_echo = false;//console output to stdout
+const char* host_input = "";//console input
+
+static std::chrono::steady_clock::time_point host_t0 = std::chrono::steady_clock::now();
+unsigned long host_delay_ms = 0;
+
+unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - host_t0).count() + host_delay_ms * 1000UL;
+}
+unsigned long millis() { return micros() / 1000UL; }
+void delay(unsigned long ms) { host_delay_ms += ms; }
+void delayMicroseconds(unsigned int) {}
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return 0; }
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin == SRAM_SS_pin) {
+    SRAM.select(val == LOW);
+  }
+}
+
+int HostSerial::available() { return (*host_input != 0) ? 1 : 0; }
+int HostSerial::read() { return (*host_input != 0) ? (uint8_t)*host_input++ : -1; }
+size_t HostSerial::write(uint8_t c) {
+  if (host_echo) {
+    putchar(c);
+  }
+  return 1;
+}
+
+//check result
+int host_fails = 0;
+void check(bool ok, const char* what) {
+  printf("%s: %s\n", ok ? "OK  " : "FAIL", what);
+  if (!ok) {
+    host_fails++;
+  }
+}
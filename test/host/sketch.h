@@ -0,0 +1,25 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//HOST BUILD
+//sketch with the stand-ins, boot helpers
+#pragma once
+#include "host.h"
+#include "cpm4nano.ino"
+
+//boot as on the board: bank 0 RAM test, monitor prompt
+void host_boot() {
+  host_input = "0";//RAM test - bank 0
+  setup();
+  host_input = "";
+}
+
+//one instruction at PC
+void host_step() {
+  _AB = _PC;
+  _FETCH_OP();
+  (_DECODE()) ();
+}
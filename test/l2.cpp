@@ -0,0 +1,128 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//L2 CHECK
+//L2_SPIRAM 1, 23K256 stand-in behind SpiRAM.cpp:
+//lines of one cache set written - L1 evictions (through the victim buffer, if any),
+//dirty lines written through to SD & L2,
+//written back lines read again - L2 hits, no SD I/O; line not in L2 - L2 miss, SD read
+//run.sh builds it with L2_SPIRAM 1, exit code - failed checks number
+#include "sketch.h"
+
+const uint16_t T_BASE = 0x3000;//first line (set 0)
+const uint8_t T_LINES = 2 * CACHE_WAYS + VICTIM_NUM;//lines of one set - first CACHE_WAYS through to L2
+const uint16_t T_OTHER = 0x5000;//line not in L2 (slot taken by RAM test lines)
+
+//line k of the set
+uint16_t line_adr(uint8_t k) {
+  return T_BASE + k * CACHE_SETS * CACHE_LINE_SIZE;
+}
+
+//test pattern
+uint8_t pattern(uint8_t k, uint8_t i) {
+  return (k * CACHE_LINE_SIZE + i) ^ 0xA5;
+}
+
+//line data as written to SD: data, LRC, generation
+bool sd_line(uint16_t tag, uint8_t k) {
+  uint8_t* p;
+  uint8_t i;
+  uint8_t lrc;
+#if SD_PACK
+  p = card.at(tag / CACHE.PACK + SD_MEM_OFFSET).data() + (tag % CACHE.PACK) * (CACHE_LINE_SIZE + 3);
+#else
+  p = card.at(tag + SD_MEM_OFFSET).data();
+#endif
+  lrc = 0;
+  for (i = 0; i < CACHE_LINE_SIZE; i++) {
+    if (p[i] != pattern(k, i)) {
+      return false;
+    }
+    lrc = lrc ^ p[i];
+  }
+  return (p[CACHE_LINE_SIZE] == lrc) && (word(p[CACHE_LINE_SIZE + 2], p[CACHE_LINE_SIZE + 1]) == SWAP_GEN);
+}
+
+//L2 slot: tag (low byte first) & line data
+bool l2_slot(uint16_t tag, uint8_t k) {
+  uint8_t* p;
+  uint8_t i;
+  p = SRAM.mem + (tag % L2_SLOTS_NUM) * L2_SLOT_SIZE;
+  if (word(p[1], p[0]) != tag) {
+    return false;
+  }
+  for (i = 0; i < CACHE_LINE_SIZE; i++) {
+    if (p[2 + i] != pattern(k, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  uint8_t k;
+  uint8_t i;
+  bool ok;
+  uint32_t rd;
+  uint32_t wr;
+  uint32_t hits;
+  uint32_t misses;
+  uint8_t* p;
+  host_boot();
+  //RAM test lines written back, empty cache
+  while (CACHE.flush_one()) {};
+  cache_init();
+  CACHE.prefetch = false;//fills on demand only
+  //dirty lines: first CACHE_WAYS out to SD & L2, next VICTIM_NUM in the victim buffer, last CACHE_WAYS cached
+  for (k = 0; k < T_LINES; k++) {
+    for (i = 0; i < CACHE_LINE_SIZE; i++) {
+      _setMEM(line_adr(k) + i, pattern(k, i));
+    }
+  }
+  ok = true;
+  for (k = 0; k < T_LINES - CACHE_WAYS; k++) {
+    ok = ok && (CACHE.probe(_mem_tag(line_adr(k))) == CACHE_ERR);
+  }
+  for (k = T_LINES - CACHE_WAYS; k < T_LINES; k++) {
+    ok = ok && (CACHE.probe(_mem_tag(line_adr(k))) != CACHE_ERR);
+  }
+  check(ok, "L1 evict - first lines of the set out, last ones cached");
+  ok = true;
+  for (k = 0; k < CACHE_WAYS; k++) {
+    ok = ok && sd_line(_mem_tag(line_adr(k)), k);
+  }
+  check(ok, "dirty write-through - evicted lines on SD (data, LRC, generation)");
+  ok = true;
+  for (k = 0; k < CACHE_WAYS; k++) {
+    ok = ok && l2_slot(_mem_tag(line_adr(k)), k);
+  }
+  check(ok, "dirty write-through - evicted lines in L2 (tag, data)");
+  //cached & victim buffer lines written back, evictions clean from now on
+  while (CACHE.flush_one()) {};
+  rd = card.reads;
+  wr = card.writes;
+  hits = L2_HITS;
+  ok = true;
+  for (k = 0; k < CACHE_WAYS; k++) {
+    for (i = 0; i < CACHE_LINE_SIZE; i++) {
+      ok = ok && (_getMEM(line_adr(k) + i) == pattern(k, i));
+    }
+  }
+  check(ok, "L2 hit - evicted lines read back");
+  check(L2_HITS - hits == CACHE_WAYS, "L2 hit - one hit per line");
+  check((card.reads == rd) && (card.writes == wr), "L2 hit - no SD I/O");
+  p = SRAM.mem + (_mem_tag(T_OTHER) % L2_SLOTS_NUM) * L2_SLOT_SIZE;
+  check(word(p[1], p[0]) != _mem_tag(T_OTHER), "L2 miss - line not in its slot");
+#if SD_PACK
+  p = card.at(_mem_tag(T_OTHER) / CACHE.PACK + SD_MEM_OFFSET).data() + (_mem_tag(T_OTHER) % CACHE.PACK) * (CACHE_LINE_SIZE + 3);
+#else
+  p = card.at(_mem_tag(T_OTHER) + SD_MEM_OFFSET).data();
+#endif
+  misses = L2_MISSES;
+  ok = (_getMEM(T_OTHER) == p[0]);
+  check(ok && (L2_MISSES - misses == 1) && (card.reads - rd == 1), "L2 miss - line read from SD");
+  return host_fails;
+}
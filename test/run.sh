@@ -0,0 +1,72 @@
+#!/bin/sh
+#  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0
+#  host checks: the sketch is built with g++ against the stand-ins in test/host
+#  (Arduino core, EEPROM, SD card, SPI bus with 23K256) and the test programs run
+#  usage: test/run.sh
+set -e
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+#B00000000..B11111111 constants (Arduino binary.h)
+bin() {
+  w=1
+  while [ $w -le 8 ]; do
+    n=0
+    while [ $n -lt $((1 << w)) ]; do
+      b=""; i=$((w - 1))
+      while [ $i -ge 0 ]; do b="$b$(((n >> i) & 1))"; i=$((i - 1)); done
+      echo "#define B$b $n"
+      n=$((n + 1))
+    done
+    w=$((w + 1))
+  done
+}
+bin > "$work/binary.h"
+
+#build <name> <test program> [sed script - sketch switches]
+build() {
+  d="$work/$1"
+  mkdir -p "$d"
+  cp "$root"/*.h "$root"/*.ino "$root"/SpiRAM.cpp "$d/"
+  cp "$d/Sys.h" "$d/SYS.h"
+  cp -r "$root"/test/host/. "$d/"
+  cp "$root/test/$2" "$work/binary.h" "$d/"
+  if [ -n "$3" ]; then
+    sed -i "$3" "$d"/*.h "$d"/*.ino
+  fi
+  g++ -std=gnu++17 -O2 -w -I"$d" -o "$d/run" "$d/$2" "$d/SpiRAM.cpp"
+}
+
+#lazy flags - same PSW as eager evaluation, both as the baseline per-op flag code & 8080
+build eager flags.cpp 's/^#define LAZY_FLAGS 1/#define LAZY_FLAGS 0/'
+build lazy flags.cpp 's/^#define LAZY_FLAGS 0/#define LAZY_FLAGS 1/'
+fail=""
+for v in eager lazy; do
+  "$work/$v/run" > "$work/$v.txt" || fail=1
+  grep -v "^[0-9A-F][0-9A-F] [0-9]* [0-9A-F]*$" "$work/$v.txt" | sed "s/^\(....\): /\1: $v - /"
+done
+if [ -n "$fail" ]; then
+  exit 1
+fi
+if cmp -s "$work/eager.txt" "$work/lazy.txt"; then
+  echo "OK  : LAZY_FLAGS 0 / 1 - $(grep -c "^[0-9A-F][0-9A-F] [0-9]* [0-9A-F]*$" "$work/eager.txt") opcodes, same PSW"
+else
+  echo "FAIL: LAZY_FLAGS 0 / 1 - PSW differs (opcode, runs, hash)"
+  diff "$work/eager.txt" "$work/lazy.txt" || true
+  exit 1
+fi
+
+#L2 - 23K256 behind the SPI seam: L1 evict, dirty write-through, L2 hit
+build l2 l2.cpp 's/^#define L2_SPIRAM 0/#define L2_SPIRAM 1/'
+"$work/l2/run"
+
+#attention - call() exit points, fast path batch of one & eight instructions
+build atn1 atn.cpp
+"$work/atn1/run"
+build atn8 atn.cpp 's/^#define ATN_BATCH 1$/#define ATN_BATCH 8/'
+"$work/atn8/run"
+
+#swap generation - kept on the card
+build swap swap.cpp
+"$work/swap/run"
@@ -0,0 +1,88 @@
+/*  CPM4NANO - i8080 & CP/M emulator for Arduino Nano 3.0 
+*   Copyright (C) 2017 - Alexey V. Voronin @ FoxyLab 
+*   Email:    support@foxylab.com
+*   Website:  https://acdc.foxylab.com
+*/
+
+//SWAP GENERATION CHECK
+//a line of bank 1 (not touched by the bank 0 RAM test) written back to SD, then reboots:
+//blank EEPROM (card moved to a new board) and generation wrap must not revive the line;
+//SD errors on the header: read - swap area erased, erase or write - error (0);
+//line fill SD read error - memory error, no line
+//exit code - failed checks number
+#include "sketch.h"
+
+const uint16_t T_TAG = 65536UL / CACHE_LINE_SIZE + 5;//physical line in bank 1
+#if SD_PACK
+const uint32_t T_BLK = T_TAG / CACHE.PACK + SD_MEM_OFFSET;//line SD block
+#else
+const uint32_t T_BLK = T_TAG + SD_MEM_OFFSET;
+#endif
+
+//line written & written back to SD
+void put_line() {
+  uint8_t* line;
+  uint8_t i;
+  line = _phys_line(T_TAG);
+  for (i = 0; i < CACHE_LINE_SIZE; i++) {
+    line[i] = i + 1;
+  }
+  sel_dirty();
+  while (CACHE.flush_one()) {};
+}
+
+//line reads as zeros (not written in this generation)
+bool line_zero() {
+  uint8_t* line;
+  uint8_t i;
+  line = _phys_line(T_TAG);
+  for (i = 0; i < CACHE_LINE_SIZE; i++) {
+    if (line[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//new board - blank EEPROM
+void eeprom_blank() {
+  memset(EEPROM.cell, 0xFF, sizeof(EEPROM.cell));
+}
+
+int main() {
+  uint16_t gen;
+  host_boot();
+  gen = SWAP_GEN;
+  put_line();
+  check(!line_zero(), "line written back, read in the same generation");
+  host_boot();
+  check((SWAP_GEN == gen + 1) && line_zero(), "reboot - next generation, line reads zeros");
+  put_line();
+  gen = SWAP_GEN;
+  eeprom_blank();
+  host_boot();
+  check((SWAP_GEN == gen + 1) && line_zero(), "blank EEPROM - generation from the card, line reads zeros");
+  put_line();
+  card.at(SWAP_HDR_BLK)[2] = 0xFE;//generation 0xFFFE
+  card.at(SWAP_HDR_BLK)[3] = 0xFF;
+  eeprom_blank();
+  host_boot();
+  check((SWAP_GEN == 1) && line_zero(), "generation wrap - swap area erased, line reads zeros");
+  put_line();
+  gen = SWAP_GEN;
+  card.fail = SD_FAIL_READ;
+  gen = swap_gen_next(gen);
+  card.fail = 0;
+  check((gen != 0) && (card.sec.count(T_BLK) == 0), "header read error - swap area erased");
+  card.fail = SD_FAIL_WRITE;
+  check(swap_gen_next(gen) == 0, "header write error - reported");
+  card.fail = SD_FAIL_ERASE | SD_FAIL_READ;
+  check(swap_gen_next(gen) == 0, "erase error - reported");
+  cache_init();
+  card.fail = SD_FAIL_READ;
+  check((_phys_line(T_TAG) == NULL) && MEM_ERR && (CACHE.probe(T_TAG) == CACHE_ERR), "line read error - memory error, line not cached");
+  card.fail = 0;
+  MEM_ERR = false;
+  ATN = 0;
+  return host_fails;
+}